@@ -1,108 +1,207 @@
 #include "big_integer.hpp"
 
 const int kMaxDigitsInElement = 9;
-const int kIncreaseLen = 10;
 
-BigInt::BigInt() = default;
+BigInt::BigInt() : num_(1, 0) {}
 
 BigInt::BigInt(std::string number) {
-  if (number.length() == 0 || isdigit(number[0]) != 0) {
-    IsNegative_ = false;
-  } else {
-    IsNegative_ = true;
-    start_ = 1;
+  size_t start = 0;
+  if (!number.empty() && (number[0] == '-' || number[0] == '+')) {
+    IsNegative_ = number[0] == '-';
+    start = 1;
   }
-  for (int i = number.length() - 1; i >= start_; i -= kMaxDigitsInElement) {
-    int res = 0;
-    if (i < kMaxDigitsInElement) {
-      int k = i;
-      for (int j = start_; j < i + 1; j++) {
-        int sum = number[j] - '0';
-        res += sum;
-        if (j != i) {
-          res *= kIncreaseLen;
-        }
-      }
-    } else {
-      for (int j = kMaxDigitsInElement - 1; j >= 0; j--) {
-        int sum = number[i - j] - '0';
-        res += sum;
-        if (j != 0) {
-          res *= kIncreaseLen;
-        }
+  if (start == number.length()) {
+    throw std::invalid_argument("Not a number: " + number);
+  }
+  for (size_t end = number.length(); end > start;) {
+    size_t begin = end - std::min<size_t>(kMaxDigitsInElement, end - start);
+    uint32_t res = 0;
+    for (size_t j = begin; j < end; ++j) {
+      if (isdigit(static_cast<unsigned char>(number[j])) == 0) {
+        throw std::invalid_argument("Not a number: " + number);
       }
+      res = res * 10 + static_cast<uint32_t>(number[j] - '0');
     }
     num_.push_back(res);
+    end = begin;
   }
+  delete_front_zero();
 }
 
 BigInt::BigInt(int64_t number) {
-  if (number < 0) {
-    IsNegative_ = true;
-    number *= -1;
-  }
+  IsNegative_ = number < 0;
+  // Negated in unsigned arithmetic, which also covers INT64_MIN.
+  uint64_t magnitude = IsNegative_ ? 0 - static_cast<uint64_t>(number)
+                                   : static_cast<uint64_t>(number);
   do {
-    num_.push_back(number % kMod);
-    number /= kMod;
-  } while (number != 0);
+    num_.push_back(static_cast<uint32_t>(magnitude % kMod));
+    magnitude /= kMod;
+  } while (magnitude != 0);
 }
 
-BigInt::BigInt(const BigInt& number) {
-  IsNegative_ = number.IsNegative_;
-  for (size_t i = 0; i < number.num_.size(); i++) {
-    num_.push_back(number.num_[i]);
+int BigInt::CompareAbs(const std::vector<uint32_t>& lhs,
+                       const std::vector<uint32_t>& rhs) {
+  if (lhs.size() != rhs.size()) {
+    return lhs.size() < rhs.size() ? -1 : 1;
   }
+  for (size_t i = lhs.size(); i-- > 0;) {
+    if (lhs[i] != rhs[i]) {
+      return lhs[i] < rhs[i] ? -1 : 1;
+    }
+  }
+  return 0;
 }
 
-BigInt BigInt::operator+(const BigInt& number2) {
-  BigInt res;
-  int remain = 0;
-  int sum = 0;
-  size_t max =
-      num_.size() > number2.num_.size() ? num_.size() : number2.num_.size();
-  if (IsNegative_ == number2.IsNegative_) {
-    res.IsNegative_ = IsNegative_;
-    for (size_t j = 0; j < max; j++) {
-      sum = (num_[j] + number2.num_[j] + remain) % kMod;
-      remain = sum / kMod;
-      res.num_.push_back(sum);
+std::vector<uint32_t> BigInt::AddAbs(const std::vector<uint32_t>& lhs,
+                                     const std::vector<uint32_t>& rhs) {
+  const std::vector<uint32_t>& longer = lhs.size() < rhs.size() ? rhs : lhs;
+  const std::vector<uint32_t>& shorter = lhs.size() < rhs.size() ? lhs : rhs;
+  std::vector<uint32_t> res;
+  res.reserve(longer.size() + 1);
+  uint32_t carry = 0;
+  for (size_t i = 0; i < longer.size(); ++i) {
+    uint32_t sum = longer[i] + carry + (i < shorter.size() ? shorter[i] : 0);
+    carry = sum >= kMod ? 1 : 0;
+    res.push_back(sum - carry * kMod);
+  }
+  if (carry != 0) {
+    res.push_back(carry);
+  }
+  return res;
+}
+
+std::vector<uint32_t> BigInt::SubtractAbs(const std::vector<uint32_t>& lhs,
+                                          const std::vector<uint32_t>& rhs) {
+  std::vector<uint32_t> res;
+  res.reserve(lhs.size());
+  int64_t borrow = 0;
+  for (size_t i = 0; i < lhs.size(); ++i) {
+    int64_t diff = int64_t(lhs[i]) - borrow - (i < rhs.size() ? rhs[i] : 0);
+    borrow = diff < 0 ? 1 : 0;
+    res.push_back(static_cast<uint32_t>(diff + borrow * kMod));
+  }
+  return res;
+}
+
+// Schoolbook long division (Knuth, TAOCP vol. 2, 4.3.1, algorithm D). Both
+// operands are first scaled so the divisor's top limb is at least kMod / 2;
+// then the quotient limb guessed from the top two limbs is at most two too
+// large, and the correction loop below almost always settles it.
+void BigInt::DivideAbs(const std::vector<uint32_t>& lhs,
+                       const std::vector<uint32_t>& rhs,
+                       std::vector<uint32_t>& quotient,
+                       std::vector<uint32_t>& remainder) {
+  if (CompareAbs(lhs, rhs) < 0) {
+    quotient.assign(1, 0);
+    remainder = lhs;
+    return;
+  }
+  size_t n = rhs.size();
+  if (n == 1) {
+    uint64_t divisor = rhs[0];
+    uint64_t rem = 0;
+    quotient.assign(lhs.size(), 0);
+    for (size_t i = lhs.size(); i-- > 0;) {
+      uint64_t cur = rem * kMod + lhs[i];
+      quotient[i] = static_cast<uint32_t>(cur / divisor);
+      rem = cur % divisor;
     }
-  } else {
-    if (*this > number2) {
-      SumNegativeNumber(*this, number2, res);
-    } else {
-      SumNegativeNumber(number2, *this, res);
+    remainder.assign(1, static_cast<uint32_t>(rem));
+    return;
+  }
+  uint64_t scale = kMod / (uint64_t(rhs.back()) + 1);
+  auto scaled = [&](const std::vector<uint32_t>& number, size_t size) {
+    std::vector<uint32_t> res(size, 0);
+    uint64_t carry = 0;
+    for (size_t i = 0; i < number.size(); ++i) {
+      uint64_t cur = number[i] * scale + carry;
+      res[i] = static_cast<uint32_t>(cur % kMod);
+      carry = cur / kMod;
     }
-    res.num_.push_back(sum);
+    if (carry != 0) {
+      res[number.size()] = static_cast<uint32_t>(carry);
+    }
+    return res;
+  };
+  std::vector<uint32_t> u = scaled(lhs, lhs.size() + 1);
+  std::vector<uint32_t> v = scaled(rhs, n);
+  size_t m = lhs.size() - n;
+  quotient.assign(m + 1, 0);
+  uint64_t top = v[n - 1];
+  uint64_t second = v[n - 2];
+  for (size_t j = m + 1; j-- > 0;) {
+    uint64_t numerator = uint64_t(u[j + n]) * kMod + u[j + n - 1];
+    uint64_t guess = numerator / top;
+    uint64_t rest = numerator % top;
+    while (guess >= kMod || guess * second > rest * kMod + u[j + n - 2]) {
+      --guess;
+      rest += top;
+      if (rest >= kMod) {
+        break;
+      }
+    }
+    // u[j, j + n] -= guess * v.
+    uint64_t carry = 0;
+    int64_t borrow = 0;
+    for (size_t i = 0; i < n; ++i) {
+      uint64_t product = guess * v[i] + carry;
+      carry = product / kMod;
+      int64_t diff = int64_t(u[i + j]) - int64_t(product % kMod) - borrow;
+      borrow = diff < 0 ? 1 : 0;
+      u[i + j] = static_cast<uint32_t>(diff + borrow * kMod);
+    }
+    int64_t head = int64_t(u[j + n]) - int64_t(carry) - borrow;
+    if (head < 0) {
+      // The guess was one too large; add v back once.
+      --guess;
+      uint32_t add_carry = 0;
+      for (size_t i = 0; i < n; ++i) {
+        uint32_t sum = u[i + j] + v[i] + add_carry;
+        add_carry = sum >= kMod ? 1 : 0;
+        u[i + j] = sum - add_carry * kMod;
+      }
+      head += add_carry;
+    }
+    u[j + n] = static_cast<uint32_t>(head);
+    quotient[j] = static_cast<uint32_t>(guess);
+  }
+  remainder.assign(n, 0);
+  uint64_t rem = 0;
+  for (size_t i = n; i-- > 0;) {
+    uint64_t cur = rem * kMod + u[i];
+    remainder[i] = static_cast<uint32_t>(cur / scale);
+    rem = cur % scale;
   }
-  return res;
 }
 
-int SumNegativeNumber(const BigInt& number1, const BigInt& number2,
-                      BigInt& res) {
-  int sum = 0;
-  int remain = 0;
-  size_t max = number1.num_.size() > number2.num_.size() ? number1.num_.size()
-                                                         : number2.num_.size();
-  BigInt de_number2 = number2;
-  de_number2.IsNegative_ = !number2.IsNegative_;
-  res.IsNegative_ =
-      number1 > de_number2 ? number1.IsNegative_ : number2.IsNegative_;
-  for (size_t j = 0; j < max; j++) {
-    sum = (number1.num_[j] - number2.num_[j] - remain) % number1.kMod;
-    remain = sum / number1.kMod;
+BigInt BigInt::AddSigned(const BigInt& lhs, const std::vector<uint32_t>& rhs,
+                         bool rhs_negative) {
+  BigInt res;
+  if (lhs.IsNegative_ == rhs_negative) {
+    res.num_ = AddAbs(lhs.num_, rhs);
+    res.IsNegative_ = rhs_negative;
+  } else if (CompareAbs(lhs.num_, rhs) >= 0) {
+    res.num_ = SubtractAbs(lhs.num_, rhs);
+    res.IsNegative_ = lhs.IsNegative_;
+  } else {
+    res.num_ = SubtractAbs(rhs, lhs.num_);
+    res.IsNegative_ = rhs_negative;
   }
-  return sum;
+  res.delete_front_zero();
+  return res;
+}
+
+BigInt BigInt::operator+(const BigInt& number2) const {
+  return AddSigned(*this, number2.num_, number2.IsNegative_);
 }
+
 BigInt& BigInt::operator+=(const BigInt& number2) {
-  *this = (*this + number2);
+  *this = *this + number2;
   return *this;
 }
 
-BigInt BigInt::operator-(const BigInt& number2) {
-  BigInt buffer = *this;
-  buffer.IsNegative_ = !IsNegative_;
-  return buffer + number2;
+BigInt BigInt::operator-(const BigInt& number2) const {
+  return AddSigned(*this, number2.num_, !number2.IsNegative_);
 }
 
 BigInt& BigInt::operator-=(const BigInt& number2) {
@@ -110,31 +209,24 @@ BigInt& BigInt::operator-=(const BigInt& number2) {
   return *this;
 }
 
-BigInt BigInt::operator*(const BigInt& number2) {
+BigInt BigInt::operator*(const BigInt& number2) const {
   BigInt res;
-  res.IsNegative_ = IsNegative_ ^ number2.IsNegative_;
-  res.num_.resize(num_.size(), number2.num_.size());
-  for (size_t i = 0; i < res.num_.size(); ++i) {
-    int elem = 0;
-    size_t index = res.num_.size() - i - 1;
-    for (size_t j = 0; j <= index; ++j) {
-      size_t dif = index - j;
-      if (j < num_.size() && dif < number2.num_.size()) {
-        elem += num_[j] * number2.num_[dif];
-      }
+  res.num_.assign(num_.size() + number2.num_.size(), 0);
+  for (size_t i = 0; i < num_.size(); ++i) {
+    uint64_t elem = num_[i];
+    if (elem == 0) {
+      continue;
     }
-    res.num_[index] = elem;
-  }
-  int rem = 0;
-  for (auto& digital : num_) {
-    digital += rem;
-    rem = digital / kMod;
-    digital %= kMod;
-  }
-  while (rem > 0) {
-    num_.push_back(rem % kMod);
-    rem /= kMod;
+    uint64_t carry = 0;
+    for (size_t j = 0; j < number2.num_.size(); ++j) {
+      // At most (kMod - 1) + (kMod - 1)^2 + (kMod - 1), below 2^64.
+      uint64_t cur = res.num_[i + j] + elem * number2.num_[j] + carry;
+      res.num_[i + j] = static_cast<uint32_t>(cur % kMod);
+      carry = cur / kMod;
+    }
+    res.num_[i + number2.num_.size()] = static_cast<uint32_t>(carry);
   }
+  res.IsNegative_ = IsNegative_ != number2.IsNegative_;
   res.delete_front_zero();
   return res;
 }
@@ -144,51 +236,33 @@ BigInt& BigInt::operator*=(const BigInt& number2) {
   return *this;
 }
 
-BigInt BigInt::operator/(const BigInt& number2) {
+BigInt BigInt::operator/(const BigInt& number2) const {
   if (number2.num_.size() == 1 && number2.num_[0] == 0) {
-    throw("Error: Cannot be divided by 0");
+    throw std::invalid_argument("Division by zero");
   }
   BigInt res;
-  res.IsNegative_ = IsNegative_ ^ number2.IsNegative_;
-  BigInt positive_number1 = *this;
-  BigInt positive_number2 = number2;
-  positive_number1.IsNegative_ = false;
-  positive_number2.IsNegative_ = false;
-  if (positive_number2 > positive_number1) {
-    res = 0;
-    res.IsNegative_ = false;
-    return res;
-  }
-  if (*this == number2) {
-    res = IsNegative_ == number2.IsNegative_ ? 1 : -1;
-    return res;
-  }
-  division_continuation(res, positive_number2, number2);
+  std::vector<uint32_t> remainder;
+  DivideAbs(num_, number2.num_, res.num_, remainder);
+  res.IsNegative_ = IsNegative_ != number2.IsNegative_;
   res.delete_front_zero();
   return res;
 }
 
-void BigInt::division_continuation(BigInt res, BigInt& positive_number2,
-                                   const BigInt& number2) {
-  BigInt del = 0;
-  for (int iter = num_.size() - 1; iter >= 0; --iter) {
-    del = del * kIncreaseLen + BigInt(num_[iter]);
-    int i = 0;
-    while (del > (positive_number2 * i)) {
-      i++;
-    }
-    res = res * kIncreaseLen + i;
-    del -= (positive_number2 * i);
-  }
-}
-
 BigInt& BigInt::operator/=(const BigInt& number2) {
   *this = *this / number2;
   return *this;
 }
 
-BigInt BigInt::operator%(const BigInt& number2) {
-  BigInt res = *this - *this / number2 * number2;
+BigInt BigInt::operator%(const BigInt& number2) const {
+  if (number2.num_.size() == 1 && number2.num_[0] == 0) {
+    throw std::invalid_argument("Division by zero");
+  }
+  BigInt res;
+  std::vector<uint32_t> quotient;
+  DivideAbs(num_, number2.num_, quotient, res.num_);
+  // The remainder takes the sign of the dividend.
+  res.IsNegative_ = IsNegative_;
+  res.delete_front_zero();
   return res;
 }
 
@@ -201,46 +275,23 @@ bool operator>(const BigInt& number1, const BigInt& number2) {
   if (number1.IsNegative_ != number2.IsNegative_) {
     return !number1.IsNegative_;
   }
-  if (number1.num_.size() > number2.num_.size()) {
-    return !number1.IsNegative_;
-  }
-  if (number1.num_.size() < number2.num_.size()) {
-    return !number1.IsNegative_;
-  }
-  for (size_t i = 0; i < number1.num_.size(); i++) {
-    if (number1.num_[number1.num_.size() - 1 - i] >
-        number2.num_[number2.num_.size() - 1 - i]) {
-      return !number1.IsNegative_;
-    }
-    if (number1.num_[number1.num_.size() - 1 - i] <
-        number2.num_[number2.num_.size() - 1 - i]) {
-      return number1.IsNegative_;
-    }
-  }
-  return false;
+  int cmp = BigInt::CompareAbs(number1.num_, number2.num_);
+  return number1.IsNegative_ ? cmp < 0 : cmp > 0;
 }
 
-bool BigInt::operator==(const BigInt& number2) {
-  if (IsNegative_ == number2.IsNegative_ &&
-      num_.size() == number2.num_.size()) {
-    for (size_t i = 0; i < num_.size(); i++) {
-      if (num_[num_.size() - 1 - i] !=
-          number2.num_[number2.num_.size() - 1 - i]) {
-        return false;
-      }
-    }
-    return true;
-  }
-  return false;
+bool BigInt::operator==(const BigInt& number2) const {
+  return IsNegative_ == number2.IsNegative_ && num_ == number2.num_;
 }
 
-bool BigInt::operator!=(const BigInt& number2) { return !(*this == number2); }
+bool BigInt::operator!=(const BigInt& number2) const {
+  return !(*this == number2);
+}
 
-bool BigInt::operator>=(const BigInt& number2) {
-  return *this == number2 || *this > number2;
+bool BigInt::operator>=(const BigInt& number2) const {
+  return !(number2 > *this);
 }
 
-bool BigInt::operator<(const BigInt& number2) { return !(*this >= number2); }
+bool BigInt::operator<(const BigInt& number2) const { return number2 > *this; }
 
 bool BigInt::operator<=(const BigInt& number2) const {
   return !(*this > number2);
@@ -268,9 +319,10 @@ BigInt BigInt::operator--(int) {
   return buffer;
 }
 
-BigInt BigInt::operator-() {
+BigInt BigInt::operator-() const {
   BigInt res = *this;
   res.IsNegative_ = !IsNegative_;
+  res.delete_front_zero();
   return res;
 }
 
@@ -281,23 +333,13 @@ std::ostream& operator<<(std::ostream& out, const BigInt& number) {
 }
 
 std::string BigInt::ToString() const {
-  if (num_.empty()) {
-    return "0";
-  }
-  std::string res;
-  size_t log_base = 9;
-  for (size_t i = 0; i < num_.size(); ++i) {
-    int digital = num_[i];
-    std::string strDigital = std::to_string(digital);
-    std::reverse(strDigital.begin(), strDigital.end());
-    while (i != num_.size() - 1 && strDigital.size() != log_base) {
-      strDigital += "0";
-    }
-    res += strDigital;
-  }
-  if (IsNegative_) {
-    res += '-';
-    std::reverse(res.begin(), res.end());
+  std::string res = IsNegative_ ? "-" : "";
+  res += std::to_string(num_.back());
+  // Lower limbs are padded to all nine digits.
+  for (size_t i = num_.size() - 1; i-- > 0;) {
+    std::string digits = std::to_string(num_[i]);
+    res.append(kMaxDigitsInElement - digits.size(), '0');
+    res += digits;
   }
   return res;
 }
@@ -309,22 +351,14 @@ std::istream& operator>>(std::istream& in, BigInt& number) {
   return in;
 }
 
-BigInt& BigInt::operator=(const BigInt& number2) {
-  IsNegative_ = number2.IsNegative_;
-  for (size_t i = 0; i < number2.num_.size(); i++) {
-    num_.push_back(number2.num_[i]);
-  }
-  return *this;
-}
-
 void BigInt::delete_front_zero() {
   while (num_.size() > 1 && num_.back() == 0) {
     num_.pop_back();
-    if (num_.size() == 1 && num_[0] == 0) {
-      IsNegative_ = false;
-    }
   }
   if (num_.empty()) {
+    num_.push_back(0);
+  }
+  if (num_.size() == 1 && num_[0] == 0) {
     IsNegative_ = false;
   }
-}
\ No newline at end of file
+}
@@ -2,56 +2,74 @@
 #include <ctype.h>
 
 #include <algorithm>
+#include <cstdint>
 #include <iostream>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
+// Arbitrary precision signed integer. The magnitude is kept in base 10^9
+// limbs, least significant first, without leading zero limbs; zero is a
+// single 0 limb and never negative. Division truncates toward zero, like
+// the builtin integers.
 class BigInt {
  public:
   BigInt();
   BigInt(std::string number);
   BigInt(int64_t number);
-  BigInt(const BigInt& number);
+  BigInt(const BigInt& number) = default;
+  BigInt(BigInt&& number) = default;
 
-  BigInt operator+(const BigInt& number2);
+  BigInt operator+(const BigInt& number2) const;
   BigInt& operator+=(const BigInt& number2);
-  BigInt operator-(const BigInt& number2);
+  BigInt operator-(const BigInt& number2) const;
   BigInt& operator-=(const BigInt& number2);
-  BigInt operator*(const BigInt& number2);
+  BigInt operator*(const BigInt& number2) const;
   BigInt& operator*=(const BigInt& number2);
-  BigInt operator/(const BigInt& number2);
+  BigInt operator/(const BigInt& number2) const;
   BigInt& operator/=(const BigInt& number2);
-  BigInt operator%(const BigInt& number2);
+  BigInt operator%(const BigInt& number2) const;
   BigInt& operator%=(const BigInt& number2);
 
   friend bool operator>(const BigInt& number1, const BigInt& number2);
-  bool operator<(const BigInt& number2);
-  bool operator>=(const BigInt& number2);
+  bool operator<(const BigInt& number2) const;
+  bool operator>=(const BigInt& number2) const;
   bool operator<=(const BigInt& number2) const;
-  bool operator==(const BigInt& number2);
-  bool operator!=(const BigInt& number2);
+  bool operator==(const BigInt& number2) const;
+  bool operator!=(const BigInt& number2) const;
 
   BigInt& operator--();
   BigInt operator--(int);
   BigInt& operator++();
   BigInt operator++(int);
-  BigInt& operator=(const BigInt& number2);
-  BigInt operator-();
+  BigInt& operator=(const BigInt& number2) = default;
+  BigInt& operator=(BigInt&& number2) = default;
+  BigInt operator-() const;
 
   friend std::ostream& operator<<(std::ostream& os, const BigInt& number);
-  friend std::istream& operator>>(std::istream& in, const BigInt& number);
+  friend std::istream& operator>>(std::istream& in, BigInt& number);
 
-  void division_continuation(BigInt res, BigInt& positive_number2,
-                             const BigInt& number2);
-  friend int SumNegativeNumber(const BigInt& number1, const BigInt& number2,
-                               BigInt& res);
+ private:
+  static const uint32_t kMod = 1000000000;
+
+  // Helpers on magnitudes, which ignore the signs.
+  static int CompareAbs(const std::vector<uint32_t>& lhs,
+                        const std::vector<uint32_t>& rhs);
+  static std::vector<uint32_t> AddAbs(const std::vector<uint32_t>& lhs,
+                                      const std::vector<uint32_t>& rhs);
+  // Requires lhs >= rhs.
+  static std::vector<uint32_t> SubtractAbs(const std::vector<uint32_t>& lhs,
+                                           const std::vector<uint32_t>& rhs);
+  static void DivideAbs(const std::vector<uint32_t>& lhs,
+                        const std::vector<uint32_t>& rhs,
+                        std::vector<uint32_t>& quotient,
+                        std::vector<uint32_t>& remainder);
+  static BigInt AddSigned(const BigInt& lhs, const std::vector<uint32_t>& rhs,
+                          bool rhs_negative);
   void delete_front_zero();
 
- private:
-  std::vector<int> num_;
+  std::vector<uint32_t> num_;
   bool IsNegative_ = false;
-  int start_ = 0;
-  int const kMod = 1000000000;
 
   std::string ToString() const;
-};
\ No newline at end of file
+};
@@ -3,6 +3,7 @@
 #include <cstddef>
 #include <iostream>
 #include <iterator>
+#include <utility>
 #include <vector>
 
 template <typename T>
@@ -28,6 +29,18 @@ class Deque {
 
   Deque(const Deque& deque2) { copy(deque2); }
 
+  Deque(Deque&& deque2) noexcept
+      : size_(deque2.size_),
+        first_block_(deque2.first_block_),
+        last_block_(deque2.last_block_),
+        first_elem_(deque2.first_elem_),
+        last_elem_(deque2.last_elem_),
+        deque_(std::move(deque2.deque_)) {
+    deque2.deque_.clear();
+    deque2.size_ = 0;
+    deque2.make_it_zero();
+  }
+
   Deque(size_t count) { create(count); }
 
   Deque(size_t count, const T& value) {
@@ -158,6 +171,23 @@ class Deque {
     return *this;
   }
 
+  Deque<T>& operator=(Deque<T>&& other) noexcept {
+    if (this == &other) {
+      return *this;
+    }
+    clear();
+    deque_ = std::move(other.deque_);
+    size_ = other.size_;
+    first_block_ = other.first_block_;
+    last_block_ = other.last_block_;
+    first_elem_ = other.first_elem_;
+    last_elem_ = other.last_elem_;
+    other.deque_.clear();
+    other.size_ = 0;
+    other.make_it_zero();
+    return *this;
+  }
+
   size_t size() const { return size_; }
 
   bool empty() const { return size_ == 0; }
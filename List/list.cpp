@@ -3,6 +3,7 @@
 #include <initializer_list>
 #include <iostream>
 #include <memory>
+#include <utility>
 
 template <typename T, typename Allocator = std::allocator<T>>
 class List {
@@ -112,6 +113,15 @@ class List {
     }
   }
 
+  List(List&& other) noexcept
+      : head_(other.head_),
+        Fake_node_(other.Fake_node_),
+        tail_(other.tail_),
+        size_(other.size_),
+        alloc_(std::move(other.alloc_)) {
+    other.forget_nodes();
+  }
+
   List(std::initializer_list<T> init, const Allocator& alloc = Allocator())
       : alloc_(alloc) {
     for (auto iter = init.begin(); iter != init.end(); ++iter) {
@@ -121,6 +131,14 @@ class List {
 
   ~List() { delete_list(); }
 
+  // Drops ownership of the nodes after they were handed to another list.
+  void forget_nodes() {
+    head_ = nullptr;
+    Fake_node_ = nullptr;
+    tail_ = nullptr;
+    size_ = 0;
+  }
+
   void fake_node() { Fake_node_ = alloc_traits::allocate(alloc_, 1); }
 
   void delete_list() {
@@ -266,6 +284,35 @@ class List {
     return *this;
   }
 
+  List& operator=(List&& other) noexcept(
+      alloc_traits::propagate_on_container_move_assignment::value ||
+      alloc_traits::is_always_equal::value) {
+    if (this == &other) {
+      return *this;
+    }
+    if (!alloc_traits::propagate_on_container_move_assignment::value &&
+        !alloc_traits::is_always_equal::value && alloc_ != other.alloc_) {
+      // Nodes of a different allocator cannot be adopted, so move the values.
+      delete_list();
+      Node* current = other.head_;
+      for (size_t i = 0; i < other.size_; ++i) {
+        push_back(std::move(current->value));
+        current = current->next;
+      }
+      return *this;
+    }
+    delete_list();
+    if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+      alloc_ = std::move(other.alloc_);
+    }
+    head_ = other.head_;
+    Fake_node_ = other.Fake_node_;
+    tail_ = other.tail_;
+    size_ = other.size_;
+    other.forget_nodes();
+    return *this;
+  }
+
   T& front() { return head_->value; }
   const T& front() const { return head_->value; }
   T& back() { return tail_->value; }
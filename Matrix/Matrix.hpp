@@ -1,179 +1,353 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <iostream>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "MatrixGemm.hpp"
+#include "MatrixSimd.hpp"
+#include "MatrixTranspose.hpp"
+
+// Matrices with at most kSmallMatrixElements elements live entirely on the
+// stack and are constexpr-capable; bigger ones keep a single contiguous
+// row-major heap buffer.
+const size_t kSmallMatrixElements = 16;
+
+template <size_t N, size_t M>
+constexpr bool kIsSmallMatrix = N * M <= kSmallMatrixElements;
+
+template <size_t N, size_t M, typename T>
+using MatrixStorage = std::conditional_t<kIsSmallMatrix<N, M>,
+                                         std::array<T, N * M>, std::vector<T>>;
+
+template <size_t... I, typename F>
+constexpr void StaticFor(std::index_sequence<I...> /*unused*/, F&& func) {
+  (func(std::integral_constant<size_t, I>{}), ...);
+}
+
+template <size_t N, typename T>
+class LuDecomposition;
+
+template <size_t N, size_t M, typename T>
+class BareissElimination;
+
+template <typename T>
+class MatrixView;
+
+template <typename T>
+using ConstMatrixView = MatrixView<const T>;
+
 template <size_t N, size_t M, typename T = int64_t>
 class Matrix {
  public:
-  Matrix() = default;
+  constexpr Matrix() = default;
   Matrix(std::vector<std::vector<T>>& matrix2);
-  Matrix(T elem);
-  Matrix(Matrix<N, M, T>& matrix2);
+  constexpr Matrix(T elem);
+  explicit Matrix(ConstMatrixView<T> view);
+  constexpr Matrix(const Matrix<N, M, T>& matrix2) = default;
+  constexpr Matrix(Matrix<N, M, T>&& matrix2) noexcept = default;
+
+  constexpr Matrix<N, M, T> operator+(const Matrix<N, M, T>& matrix2) const;
+  constexpr Matrix<N, M, T> operator-(const Matrix<N, M, T>& matrix2) const;
+  constexpr Matrix<N, M, T>& operator+=(const Matrix<N, M, T>& matrix2);
+  constexpr Matrix<N, M, T>& operator-=(const Matrix<N, M, T>& matrix2);
+  constexpr Matrix<N, M, T>& operator=(const Matrix<N, M, T>& matrix2) =
+      default;
+  constexpr Matrix<N, M, T>& operator=(Matrix<N, M, T>&& matrix2) noexcept =
+      default;
+
+  constexpr Matrix<N, M, T> operator*(T elem) const;
+  template <size_t R>
+  constexpr Matrix<N, R, T> operator*(const Matrix<M, R, T>& matrix2) const;
 
-  Matrix<N, M, T> operator+(const Matrix<N, M, T>& matrix2) const;
-  Matrix<N, M, T> operator-(const Matrix<N, M, T>& matrix2) const;
-  Matrix<N, M, T>& operator+=(const Matrix<N, M, T>& matrix2);
-  Matrix<N, M, T>& operator-=(const Matrix<N, M, T>& matrix2);
-  Matrix<N, M, T>& operator=(const Matrix<N, M, T>& matrix2);
+  Matrix<N, M, T> Pow(uint64_t exponent) const;
 
-  Matrix<N, M, T> operator*(T elem) const;
+  constexpr Matrix<M, N, T> Transposed() const;
+  constexpr void TransposeInPlace();
+  constexpr T Trace() const;
+  constexpr T Determinant() const;
+  Matrix<N, M, T> Inverse() const;
   template <size_t R>
-  Matrix<N, R, T> operator*(const Matrix<M, R, T>& matrix2) const;
+  Matrix<N, R, T> Solve(const Matrix<N, R, T>& rhs) const;
 
-  Matrix<M, N, T> Transposed();
-  T Trace();
+  constexpr T operator()(size_t row, size_t column) const;
+  constexpr T& operator()(size_t row, size_t column);
 
-  T operator()(size_t row, size_t column) const;
-  T& operator()(size_t row, size_t column);
+  constexpr T* Data();
+  constexpr const T* Data() const;
+
+  MatrixView<T> View();
+  ConstMatrixView<T> View() const;
+  MatrixView<T> Block(size_t row, size_t column, size_t rows, size_t cols);
+  ConstMatrixView<T> Block(size_t row, size_t column, size_t rows,
+                           size_t cols) const;
+  MatrixView<T> Row(size_t row);
+  ConstMatrixView<T> Row(size_t row) const;
+  MatrixView<T> Column(size_t column);
+  ConstMatrixView<T> Column(size_t column) const;
 
   template <size_t P, size_t Y>
-  bool operator==(const Matrix<P, Y, T>& matrix2);
-  private:
-    std::vector<std::vector<T>> matrix_ =
-      std::vector<std::vector<T>>(N, std::vector<T>(M, T()));
+  constexpr bool operator==(const Matrix<P, Y, T>& matrix2) const;
+
+ private:
+  static constexpr MatrixStorage<N, M, T> MakeStorage();
+
+  MatrixStorage<N, M, T> matrix_ = MakeStorage();
 };
 
 template <size_t N, size_t M, typename T>
-Matrix<N, M, T>& Matrix<N, M, T>::operator=(const Matrix<N, M, T>& matrix2) {
-  for (size_t i = 0; i < N; ++i) {
-    for (size_t j = 0; j < M; ++j) {
-      this->matrix_[i][j] = matrix2.matrix_[i][j];
-    }
+constexpr MatrixStorage<N, M, T> Matrix<N, M, T>::MakeStorage() {
+  if constexpr (kIsSmallMatrix<N, M>) {
+    return MatrixStorage<N, M, T>{};
+  } else {
+    return std::vector<T>(N * M, T());
   }
-  return *this;
 }
 
 template <size_t N, size_t M, typename T>
 Matrix<N, M, T>::Matrix(std::vector<std::vector<T>>& matrix2) {
-  this->matrix_ = matrix2;
-}
-
-template <size_t N, size_t M, typename T>
-Matrix<N, M, T>::Matrix(T elem) {
   for (size_t i = 0; i < N; ++i) {
     for (size_t j = 0; j < M; ++j) {
-      this->matrix_[i][j] = elem;
+      this->matrix_[i * M + j] = matrix2[i][j];
     }
   }
 }
 
 template <size_t N, size_t M, typename T>
-Matrix<N, M, T>::Matrix(Matrix<N, M, T>& matrix2) {
-  for (size_t i = 0; i < N; ++i) {
-    for (size_t j = 0; j < M; ++j) {
-      this->matrix_[i][j] = matrix2.matrix_[i][j];
-    }
+constexpr Matrix<N, M, T>::Matrix(T elem) {
+  for (size_t i = 0; i < N * M; ++i) {
+    this->matrix_[i] = elem;
   }
 }
 
 template <size_t N, size_t M, typename T>
-Matrix<N, M, T> Matrix<N, M, T>::operator+(
+constexpr Matrix<N, M, T> Matrix<N, M, T>::operator+(
     const Matrix<N, M, T>& matrix2) const {
   Matrix<N, M, T> res;
-  for (size_t i = 0; i < N; ++i) {
-    for (size_t j = 0; j < M; ++j) {
-      res.matrix_[i][j] = this->matrix_[i][j] + matrix2.matrix_[i][j];
-    }
+  for (size_t i = 0; i < N * M; ++i) {
+    res.matrix_[i] = this->matrix_[i] + matrix2.matrix_[i];
   }
   return res;
 }
 
 template <size_t N, size_t M, typename T>
-Matrix<N, M, T>& Matrix<N, M, T>::operator+=(const Matrix<N, M, T>& matrix2) {
-  *this = *this + matrix2;
+constexpr Matrix<N, M, T>& Matrix<N, M, T>::operator+=(
+    const Matrix<N, M, T>& matrix2) {
+  for (size_t i = 0; i < N * M; ++i) {
+    this->matrix_[i] += matrix2.matrix_[i];
+  }
   return *this;
 }
 
 template <size_t N, size_t M, typename T>
-Matrix<N, M, T> Matrix<N, M, T>::operator-(
+constexpr Matrix<N, M, T> Matrix<N, M, T>::operator-(
     const Matrix<N, M, T>& matrix2) const {
   Matrix<N, M, T> res;
-  for (size_t i = 0; i < N; ++i) {
-    for (size_t j = 0; j < M; ++j) {
-      res.matrix_[i][j] = this->matrix_[i][j] - matrix2.matrix_[i][j];
-    }
+  for (size_t i = 0; i < N * M; ++i) {
+    res.matrix_[i] = this->matrix_[i] - matrix2.matrix_[i];
   }
   return res;
 }
 
 template <size_t N, size_t M, typename T>
-Matrix<N, M, T>& Matrix<N, M, T>::operator-=(const Matrix<N, M, T>& matrix2) {
-  *this = *this - matrix2;
+constexpr Matrix<N, M, T>& Matrix<N, M, T>::operator-=(
+    const Matrix<N, M, T>& matrix2) {
+  for (size_t i = 0; i < N * M; ++i) {
+    this->matrix_[i] -= matrix2.matrix_[i];
+  }
   return *this;
 }
 
 template <size_t N, size_t M, typename T>
-Matrix<N, M, T> Matrix<N, M, T>::operator*(T elem) const {
+constexpr Matrix<N, M, T> Matrix<N, M, T>::operator*(T elem) const {
   Matrix<N, M, T> res;
-  for (size_t i = 0; i < N; ++i) {
-    for (size_t j = 0; j < M; ++j) {
-      res.matrix_[i][j] = this->matrix_[i][j] * elem;
-    }
+  for (size_t i = 0; i < N * M; ++i) {
+    res.matrix_[i] = this->matrix_[i] * elem;
   }
   return res;
 }
 
 template <size_t N, size_t M, typename T>
 template <size_t R>
-Matrix<N, R, T> Matrix<N, M, T>::operator*(
+constexpr Matrix<N, R, T> Matrix<N, M, T>::operator*(
     const Matrix<M, R, T>& matrix2) const {
   Matrix<N, R, T> res;
+  if constexpr (N == 4 && M == 4 && R == 4 && kHasSimd4x4<T>) {
+    if (!std::is_constant_evaluated()) {
+      Multiply4x4Simd(this->Data(), matrix2.Data(), res.Data());
+      return res;
+    }
+  }
+  if constexpr (kIsSmallMatrix<N, M> && kIsSmallMatrix<M, R>) {
+    // Every (i, j, k) triple is expanded at compile time.
+    StaticFor(std::make_index_sequence<N * R>{}, [&](auto cell) {
+      constexpr size_t kRow = decltype(cell)::value / R;
+      constexpr size_t kColumn = decltype(cell)::value % R;
+      StaticFor(std::make_index_sequence<M>{}, [&](auto k) {
+        res(kRow, kColumn) += (*this)(kRow, k) * matrix2(k, kColumn);
+      });
+    });
+  } else {
+    Gemm(N, R, M, this->Data(), M, matrix2.Data(), R, res.Data(), R);
+  }
+  return res;
+}
+
+// Binary exponentiation. The running result, the running square and one
+// scratch buffer are allocated once; every product is written into the
+// scratch buffer, which is then swapped with its target.
+template <size_t N, size_t M, typename T>
+Matrix<N, M, T> Matrix<N, M, T>::Pow(uint64_t exponent) const {
+  static_assert(N == M, "Pow is defined for square matrices only");
+  Matrix<N, M, T> res;
   for (size_t i = 0; i < N; ++i) {
-    for (size_t j = 0; j < R; ++j) {
-      for (size_t k = 0; k < M; ++k) {
-        res(i, j) += (*this)(i, k) * matrix2(k, j);
-      }
+    res(i, i) = T(1);
+  }
+  Matrix<N, M, T> base = *this;
+  Matrix<N, M, T> scratch;
+  auto multiply_into = [&scratch](const Matrix<N, M, T>& lhs,
+                                  const Matrix<N, M, T>& rhs) {
+    if constexpr (kIsSmallMatrix<N, M>) {
+      scratch = lhs * rhs;
+    } else {
+      std::fill(scratch.Data(), scratch.Data() + N * M, T());
+      Gemm(N, N, N, lhs.Data(), N, rhs.Data(), N, scratch.Data(), N);
+    }
+  };
+  while (exponent != 0) {
+    if ((exponent & 1) != 0) {
+      multiply_into(res, base);
+      std::swap(res, scratch);
+    }
+    exponent >>= 1;
+    if (exponent != 0) {
+      multiply_into(base, base);
+      std::swap(base, scratch);
     }
   }
   return res;
 }
 
 template <size_t N, size_t M, typename T>
-Matrix<M, N, T> Matrix<N, M, T>::Transposed() {
+constexpr Matrix<M, N, T> Matrix<N, M, T>::Transposed() const {
   Matrix<M, N, T> res;
-  for (size_t i = 0; i < M; ++i) {
-    for (size_t j = 0; j < N; ++j) {
-      res(i, j) = (*this)(j, i);
-    }
+  if constexpr (kIsSmallMatrix<N, M>) {
+    StaticFor(std::make_index_sequence<N * M>{}, [&](auto cell) {
+      constexpr size_t kRow = decltype(cell)::value / M;
+      constexpr size_t kColumn = decltype(cell)::value % M;
+      res(kColumn, kRow) = (*this)(kRow, kColumn);
+    });
+  } else {
+    TransposeBlocked(this->Data(), M, res.Data(), N, N, M);
   }
   return res;
 }
 
 template <size_t N, size_t M, typename T>
-T Matrix<N, M, T>::Trace() {
-  T res = 0;
-  if (N == M) {
+constexpr void Matrix<N, M, T>::TransposeInPlace() {
+  static_assert(N == M, "In-place transpose needs a square matrix");
+  if constexpr (kIsSmallMatrix<N, M>) {
+    for (size_t i = 0; i < N; ++i) {
+      for (size_t j = i + 1; j < N; ++j) {
+        std::swap(this->matrix_[i * N + j], this->matrix_[j * N + i]);
+      }
+    }
+  } else {
+    TransposeSquareInPlace(this->Data(), N, N);
+  }
+}
+
+template <size_t N, size_t M, typename T>
+constexpr T Matrix<N, M, T>::Trace() const {
+  static_assert(N == M, "Trace is defined for square matrices only");
+  T res = T();
+  if constexpr (kIsSmallMatrix<N, M>) {
+    StaticFor(std::make_index_sequence<N>{},
+              [&](auto i) { res += (*this)(i, i); });
+  } else {
     for (size_t i = 0; i < N; ++i) {
-      res += this->matrix_[i][i];
+      res += (*this)(i, i);
     }
-    return res;
+  }
+  return res;
+}
+
+template <size_t N, size_t M, typename T>
+constexpr T Matrix<N, M, T>::Determinant() const {
+  static_assert(N == M, "Determinant is defined for square matrices only");
+  const auto& a = *this;
+  if constexpr (!kIsSmallMatrix<N, M> && std::is_floating_point_v<T>) {
+    return LuDecomposition<N, T>(*this).Determinant();
+  } else if constexpr (!kIsSmallMatrix<N, M>) {
+    return BareissElimination<N, N, T>(*this).Determinant();
+  } else if constexpr (N == 1) {
+    return a(0, 0);
+  } else if constexpr (N == 2) {
+    return a(0, 0) * a(1, 1) - a(0, 1) * a(1, 0);
+  } else if constexpr (N == 3) {
+    return a(0, 0) * (a(1, 1) * a(2, 2) - a(1, 2) * a(2, 1)) -
+           a(0, 1) * (a(1, 0) * a(2, 2) - a(1, 2) * a(2, 0)) +
+           a(0, 2) * (a(1, 0) * a(2, 1) - a(1, 1) * a(2, 0));
+  } else {
+    // Laplace expansion along the first two rows: six 2x2 minors of the top
+    // pair times the complementary minors of the bottom pair.
+    T s0 = a(0, 0) * a(1, 1) - a(1, 0) * a(0, 1);
+    T s1 = a(0, 0) * a(1, 2) - a(1, 0) * a(0, 2);
+    T s2 = a(0, 0) * a(1, 3) - a(1, 0) * a(0, 3);
+    T s3 = a(0, 1) * a(1, 2) - a(1, 1) * a(0, 2);
+    T s4 = a(0, 1) * a(1, 3) - a(1, 1) * a(0, 3);
+    T s5 = a(0, 2) * a(1, 3) - a(1, 2) * a(0, 3);
+    T c5 = a(2, 2) * a(3, 3) - a(3, 2) * a(2, 3);
+    T c4 = a(2, 1) * a(3, 3) - a(3, 1) * a(2, 3);
+    T c3 = a(2, 1) * a(3, 2) - a(3, 1) * a(2, 2);
+    T c2 = a(2, 0) * a(3, 3) - a(3, 0) * a(2, 3);
+    T c1 = a(2, 0) * a(3, 2) - a(3, 0) * a(2, 2);
+    T c0 = a(2, 0) * a(3, 1) - a(3, 0) * a(2, 1);
+    return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
   }
 }
 
 template <size_t N, size_t M, typename T>
-T Matrix<N, M, T>::operator()(size_t row, size_t column) const {
-  return this->matrix_[row][column];
+constexpr T Matrix<N, M, T>::operator()(size_t row, size_t column) const {
+  return this->matrix_[row * M + column];
 }
 
 template <size_t N, size_t M, typename T>
-T& Matrix<N, M, T>::operator()(size_t row, size_t column) {
-  return this->matrix_[row][column];
+constexpr T& Matrix<N, M, T>::operator()(size_t row, size_t column) {
+  return this->matrix_[row * M + column];
 }
 
+template <size_t N, size_t M, typename T>
+constexpr T* Matrix<N, M, T>::Data() {
+  return this->matrix_.data();
+}
+
+template <size_t N, size_t M, typename T>
+constexpr const T* Matrix<N, M, T>::Data() const {
+  return this->matrix_.data();
+}
 
 template <size_t N, size_t M, typename T>
 template <size_t P, size_t Y>
-bool Matrix<N, M, T>::operator==(const Matrix<P, Y, T>& matrix2) {
-    if (N == P && M == Y) {
-      for (int i = 0; i < N; ++i) {
-        for (int j = 0; j < M; ++j) {
-          if (this->matrix_[i][j] != matrix2.matrix_[i][j]) {
-            return false;
-          }
+constexpr bool Matrix<N, M, T>::operator==(
+    const Matrix<P, Y, T>& matrix2) const {
+  if constexpr (N == P && M == Y) {
+    for (size_t i = 0; i < N; ++i) {
+      for (size_t j = 0; j < M; ++j) {
+        if ((*this)(i, j) != matrix2(i, j)) {
+          return false;
         }
       }
-      return true;
     }
-    return false;
-}
\ No newline at end of file
+    return true;
+  }
+  return false;
+}
+
+#include "MatrixBareiss.hpp"
+#include "MatrixLinalg.hpp"
+#include "MatrixView.hpp"
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "../Parallel/ParallelFor.hpp"
+#include "Matrix.hpp"
+
+// Fraction-free Gaussian elimination (Bareiss). Every update
+//   a[i][j] = (a[i][j] * pivot - a[i][col] * a[row][j]) / previous_pivot
+// divides exactly, so integral element types (including BigInt) never need
+// rationals and intermediate entries stay bounded by the size of minors of the
+// input. Rows below the pivot are independent and are updated in parallel
+// when the remaining block is large enough.
+const size_t kBareissParallelCells = size_t(1) << 14;
+const size_t kBareissParallelRows = 8;
+
+template <typename T>
+T BareissUpdate(const T& elem, const T& pivot, const T& lead, const T& upper,
+                const T& previous, int previous_sign) {
+  if constexpr (std::is_same_v<T, int64_t>) {
+    // The quotient fits whenever the final minors do, but the products may
+    // not: compute them in 128 bits.
+    __int128 value = static_cast<__int128>(elem) * pivot -
+                     static_cast<__int128>(lead) * upper;
+    if (previous_sign == 0) {
+      value /= previous;
+    }
+    return static_cast<T>(previous_sign < 0 ? -value : value);
+  } else {
+    T value = elem * pivot;
+    value -= lead * upper;
+    if (previous_sign > 0) {
+      return value;
+    }
+    if (previous_sign < 0) {
+      return -value;
+    }
+    return value / previous;
+  }
+}
+
+template <size_t N, size_t M, typename T>
+class BareissElimination {
+ public:
+  explicit BareissElimination(const Matrix<N, M, T>& matrix,
+                              bool parallel = true);
+
+  size_t Rank() const;
+  T Determinant() const;
+  const Matrix<N, M, T>& Echelon() const;
+
+ private:
+  void EliminateRows(size_t begin, size_t end, size_t row, size_t col,
+                     const T& previous, int previous_sign);
+
+  Matrix<N, M, T> echelon_;
+  size_t rank_ = 0;
+  bool odd_swaps_ = false;
+};
+
+template <size_t N, size_t M, typename T>
+BareissElimination<N, M, T>::BareissElimination(const Matrix<N, M, T>& matrix,
+                                                bool parallel)
+    : echelon_(matrix) {
+  T* a = echelon_.Data();
+  T previous = T(1);
+  // 1 and -1 divisors are common (the first step and unimodular inputs) and
+  // are handled without a division; 0 means a general exact division.
+  int previous_sign = 1;
+  for (size_t col = 0; col < M && rank_ < N; ++col) {
+    size_t row = rank_;
+    size_t pivot = row;
+    while (pivot < N && a[pivot * M + col] == T(0)) {
+      ++pivot;
+    }
+    if (pivot == N) {
+      continue;
+    }
+    if (pivot != row) {
+      std::swap_ranges(a + row * M, a + (row + 1) * M, a + pivot * M);
+      odd_swaps_ = !odd_swaps_;
+    }
+    size_t cells = (N - row - 1) * (M - col - 1);
+    if (parallel && cells >= kBareissParallelCells) {
+      ParallelFor(row + 1, N, kBareissParallelRows,
+                  [&](size_t begin, size_t end) {
+                    EliminateRows(begin, end, row, col, previous,
+                                  previous_sign);
+                  });
+    } else {
+      EliminateRows(row + 1, N, row, col, previous, previous_sign);
+    }
+    previous = a[row * M + col];
+    if (previous == T(1)) {
+      previous_sign = 1;
+    } else if (previous == T(-1)) {
+      previous_sign = -1;
+    } else {
+      previous_sign = 0;
+    }
+    ++rank_;
+  }
+}
+
+template <size_t N, size_t M, typename T>
+void BareissElimination<N, M, T>::EliminateRows(size_t begin, size_t end,
+                                                size_t row, size_t col,
+                                                const T& previous,
+                                                int previous_sign) {
+  T* a = echelon_.Data();
+  T pivot = a[row * M + col];
+  for (size_t i = begin; i < end; ++i) {
+    T lead = a[i * M + col];
+    for (size_t j = col + 1; j < M; ++j) {
+      a[i * M + j] = BareissUpdate(a[i * M + j], pivot, lead, a[row * M + j],
+                                   previous, previous_sign);
+    }
+    a[i * M + col] = T(0);
+  }
+}
+
+template <size_t N, size_t M, typename T>
+size_t BareissElimination<N, M, T>::Rank() const {
+  return rank_;
+}
+
+template <size_t N, size_t M, typename T>
+T BareissElimination<N, M, T>::Determinant() const {
+  static_assert(N == M, "Determinant is defined for square matrices only");
+  if (rank_ < N) {
+    return T(0);
+  }
+  T res = echelon_(N - 1, N - 1);
+  return odd_swaps_ ? -res : res;
+}
+
+template <size_t N, size_t M, typename T>
+const Matrix<N, M, T>& BareissElimination<N, M, T>::Echelon() const {
+  return echelon_;
+}
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "Matrix.hpp"
+
+// Structure-of-arrays container for many matrices of the same shape: element
+// (i, j) of every matrix is stored contiguously, so the kernels below run the
+// same scalar operation over a whole lane and the compiler turns the innermost
+// loop into full-width vector instructions (8 floats with AVX, 16 with
+// AVX-512). The lane length is padded to kBatchLaneWidth for that reason.
+const size_t kBatchLaneWidth = 16;
+
+template <size_t N, size_t M, typename T = int64_t>
+class MatrixBatch {
+ public:
+  MatrixBatch() = default;
+  explicit MatrixBatch(size_t count);
+  MatrixBatch(const std::vector<Matrix<N, M, T>>& matrices);
+
+  size_t Size() const;
+
+  void Set(size_t index, const Matrix<N, M, T>& matrix);
+  Matrix<N, M, T> Get(size_t index) const;
+  std::vector<Matrix<N, M, T>> ToMatrices() const;
+
+  T* Lane(size_t row, size_t column);
+  const T* Lane(size_t row, size_t column) const;
+
+  MatrixBatch<N, M, T> operator+(const MatrixBatch<N, M, T>& batch2) const;
+  MatrixBatch<N, M, T>& operator+=(const MatrixBatch<N, M, T>& batch2);
+  template <size_t R>
+  MatrixBatch<N, R, T> operator*(const MatrixBatch<M, R, T>& batch2) const;
+  MatrixBatch<M, N, T> Transposed() const;
+
+ private:
+  static size_t PaddedSize(size_t count);
+
+  size_t size_ = 0;
+  size_t stride_ = 0;
+  std::vector<T> data_;
+};
+
+template <size_t N, size_t M, typename T>
+size_t MatrixBatch<N, M, T>::PaddedSize(size_t count) {
+  return (count + kBatchLaneWidth - 1) / kBatchLaneWidth * kBatchLaneWidth;
+}
+
+template <size_t N, size_t M, typename T>
+MatrixBatch<N, M, T>::MatrixBatch(size_t count)
+    : size_(count),
+      stride_(PaddedSize(count)),
+      data_(N * M * stride_, T()) {}
+
+template <size_t N, size_t M, typename T>
+MatrixBatch<N, M, T>::MatrixBatch(const std::vector<Matrix<N, M, T>>& matrices)
+    : MatrixBatch(matrices.size()) {
+  for (size_t i = 0; i < N; ++i) {
+    for (size_t j = 0; j < M; ++j) {
+      T* lane = Lane(i, j);
+      for (size_t b = 0; b < size_; ++b) {
+        lane[b] = matrices[b](i, j);
+      }
+    }
+  }
+}
+
+template <size_t N, size_t M, typename T>
+size_t MatrixBatch<N, M, T>::Size() const {
+  return size_;
+}
+
+template <size_t N, size_t M, typename T>
+void MatrixBatch<N, M, T>::Set(size_t index, const Matrix<N, M, T>& matrix) {
+  if (index >= size_) {
+    throw std::out_of_range("Out of range");
+  }
+  for (size_t i = 0; i < N; ++i) {
+    for (size_t j = 0; j < M; ++j) {
+      Lane(i, j)[index] = matrix(i, j);
+    }
+  }
+}
+
+template <size_t N, size_t M, typename T>
+Matrix<N, M, T> MatrixBatch<N, M, T>::Get(size_t index) const {
+  if (index >= size_) {
+    throw std::out_of_range("Out of range");
+  }
+  Matrix<N, M, T> res;
+  for (size_t i = 0; i < N; ++i) {
+    for (size_t j = 0; j < M; ++j) {
+      res(i, j) = Lane(i, j)[index];
+    }
+  }
+  return res;
+}
+
+template <size_t N, size_t M, typename T>
+std::vector<Matrix<N, M, T>> MatrixBatch<N, M, T>::ToMatrices() const {
+  std::vector<Matrix<N, M, T>> res(size_);
+  for (size_t i = 0; i < N; ++i) {
+    for (size_t j = 0; j < M; ++j) {
+      const T* lane = Lane(i, j);
+      for (size_t b = 0; b < size_; ++b) {
+        res[b](i, j) = lane[b];
+      }
+    }
+  }
+  return res;
+}
+
+template <size_t N, size_t M, typename T>
+T* MatrixBatch<N, M, T>::Lane(size_t row, size_t column) {
+  return data_.data() + (row * M + column) * stride_;
+}
+
+template <size_t N, size_t M, typename T>
+const T* MatrixBatch<N, M, T>::Lane(size_t row, size_t column) const {
+  return data_.data() + (row * M + column) * stride_;
+}
+
+template <size_t N, size_t M, typename T>
+MatrixBatch<N, M, T> MatrixBatch<N, M, T>::operator+(
+    const MatrixBatch<N, M, T>& batch2) const {
+  MatrixBatch<N, M, T> res = *this;
+  res += batch2;
+  return res;
+}
+
+template <size_t N, size_t M, typename T>
+MatrixBatch<N, M, T>& MatrixBatch<N, M, T>::operator+=(
+    const MatrixBatch<N, M, T>& batch2) {
+  if (size_ != batch2.size_) {
+    throw std::invalid_argument("Batch sizes differ");
+  }
+  T* __restrict dst = data_.data();
+  const T* __restrict src = batch2.data_.data();
+  for (size_t i = 0; i < data_.size(); ++i) {
+    dst[i] += src[i];
+  }
+  return *this;
+}
+
+template <size_t N, size_t M, typename T>
+template <size_t R>
+MatrixBatch<N, R, T> MatrixBatch<N, M, T>::operator*(
+    const MatrixBatch<M, R, T>& batch2) const {
+  if (size_ != batch2.Size()) {
+    throw std::invalid_argument("Batch sizes differ");
+  }
+  MatrixBatch<N, R, T> res(size_);
+  for (size_t i = 0; i < N; ++i) {
+    for (size_t j = 0; j < R; ++j) {
+      T* __restrict dst = res.Lane(i, j);
+      for (size_t k = 0; k < M; ++k) {
+        const T* __restrict lhs = Lane(i, k);
+        const T* __restrict rhs = batch2.Lane(k, j);
+        for (size_t b = 0; b < stride_; ++b) {
+          dst[b] += lhs[b] * rhs[b];
+        }
+      }
+    }
+  }
+  return res;
+}
+
+template <size_t N, size_t M, typename T>
+MatrixBatch<M, N, T> MatrixBatch<N, M, T>::Transposed() const {
+  MatrixBatch<M, N, T> res(size_);
+  for (size_t i = 0; i < N; ++i) {
+    for (size_t j = 0; j < M; ++j) {
+      const T* src = Lane(i, j);
+      std::copy(src, src + stride_, res.Lane(j, i));
+    }
+  }
+  return res;
+}
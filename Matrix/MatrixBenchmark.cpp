@@ -0,0 +1,374 @@
+// Benchmark suite for the Matrix subsystem.
+//
+//   g++ -std=c++20 -O3 -march=native -pthread MatrixBenchmark.cpp -o bench
+//   ./bench [--types=int64,double,float] [--max-size=4096] [--min-time=0.2]
+//           [--json=out.json] [--compare=baseline.json] [--tolerance=0.1]
+//
+// Every (operation, element type, size) triple is timed until min-time
+// seconds have elapsed. The report gives nanoseconds per call, GFLOPS, the
+// minimal memory traffic per result element and heap allocations per call.
+// --json writes one result object per line; --compare reads such a file back
+// and exits with status 1 when any case got slower than baseline * (1 + tol).
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Matrix.hpp"
+
+namespace {
+
+std::atomic<size_t> allocations{0};
+
+struct Options {
+  std::vector<std::string> types = {"int64", "double", "float"};
+  size_t max_size = 4096;
+  double min_time = 0.2;
+  std::string json_path;
+  std::string compare_path;
+  double tolerance = 0.1;
+};
+
+struct Result {
+  std::string op;
+  std::string type;
+  size_t size = 0;
+  double ns_per_call = 0;
+  double gflops = 0;
+  double bytes_per_element = 0;
+  double allocations_per_call = 0;
+};
+
+template <typename F>
+Result Measure(const Options& options, F&& func, double flops,
+               double bytes_per_element) {
+  func();
+  // The clock is read once per batch and batches double, so timer overhead
+  // does not dominate the tiny sizes.
+  size_t iterations = 0;
+  size_t batch = 1;
+  size_t allocations_before = allocations.load();
+  auto start = std::chrono::steady_clock::now();
+  double elapsed = 0;
+  do {
+    for (size_t i = 0; i < batch; ++i) {
+      func();
+    }
+    iterations += batch;
+    batch *= 2;
+    elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                            start)
+                  .count();
+  } while (elapsed < options.min_time);
+  Result res;
+  res.ns_per_call = elapsed * 1e9 / iterations;
+  res.gflops = flops / res.ns_per_call;
+  res.bytes_per_element = bytes_per_element;
+  res.allocations_per_call =
+      double(allocations.load() - allocations_before) / iterations;
+  return res;
+}
+
+// Keeps the compiler from discarding a computed value.
+template <typename T>
+void Keep(const T& value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Keeps every element of a result, wherever the matrix stores them.
+template <typename T>
+void KeepData(const T* data) {
+  asm volatile("" : : "r"(data) : "memory");
+}
+
+// Makes the compiler assume the matrix was rewritten, so work on it can be
+// neither hoisted out of the timing loop nor folded at compile time.
+template <size_t N, size_t M, typename T>
+void Clobber(Matrix<N, M, T>& matrix) {
+  asm volatile("" : "+m"(matrix) : "r"(matrix.Data()) : "memory");
+}
+
+template <typename T>
+void Clobber(std::vector<T>& buffer) {
+  asm volatile("" : "+m"(buffer) : "r"(buffer.data()) : "memory");
+}
+
+template <typename T>
+void Fill(T* data, size_t size) {
+  for (size_t i = 0; i < size; ++i) {
+    data[i] = T(i % 17) - T(8);
+  }
+}
+
+template <typename T, size_t S>
+void BenchSize(const Options& options, const std::string& type,
+               std::vector<Result>& results) {
+  Matrix<S, S, T> lhs;
+  Matrix<S, S, T> rhs;
+  Fill(lhs.Data(), S * S);
+  Fill(rhs.Data(), S * S);
+  double elements = double(S) * S;
+  double elem_bytes = sizeof(T);
+  auto add = [&](const std::string& op, Result res) {
+    res.op = op;
+    res.type = type;
+    res.size = S;
+    results.push_back(res);
+  };
+  add("multiply", Measure(options, [&] {
+        Clobber(lhs);
+        Clobber(rhs);
+        KeepData((lhs * rhs).Data());
+      }, 2.0 * elements * S, 3 * elem_bytes));
+  add("add", Measure(options, [&] {
+        Clobber(lhs);
+        Clobber(rhs);
+        KeepData((lhs + rhs).Data());
+      }, elements, 3 * elem_bytes));
+  add("subtract", Measure(options, [&] {
+        Clobber(lhs);
+        Clobber(rhs);
+        KeepData((lhs - rhs).Data());
+      }, elements, 3 * elem_bytes));
+  add("scalar_multiply", Measure(options, [&] {
+        Clobber(lhs);
+        KeepData((lhs * T(3)).Data());
+      }, elements, 2 * elem_bytes));
+  add("transpose", Measure(options, [&] {
+        Clobber(lhs);
+        KeepData(lhs.Transposed().Data());
+      }, 0, 2 * elem_bytes));
+  // Runs on its own copy, which alternates between the two orientations.
+  Matrix<S, S, T> square = lhs;
+  add("transpose_in_place", Measure(options, [&] {
+        Clobber(square);
+        square.TransposeInPlace();
+        KeepData(square.Data());
+      }, 0, 2 * elem_bytes));
+  add("trace", Measure(options, [&] {
+        Clobber(lhs);
+        Keep(lhs.Trace());
+      }, double(S), elem_bytes * S / elements));
+}
+
+// The fixed-size path (stack storage, unrolled or SIMD kernels) against the
+// generic one that every bigger Matrix takes: a heap buffer per result and
+// the blocked Gemm and TransposeBlocked loops.
+template <typename T, size_t S>
+void BenchSmall(const Options& options, const std::string& type,
+                std::vector<Result>& results) {
+  Matrix<S, S, T> lhs;
+  Matrix<S, S, T> rhs;
+  Fill(lhs.Data(), S * S);
+  Fill(rhs.Data(), S * S);
+  std::vector<T> lhs_heap(lhs.Data(), lhs.Data() + S * S);
+  std::vector<T> rhs_heap(rhs.Data(), rhs.Data() + S * S);
+  double elements = double(S) * S;
+  double elem_bytes = sizeof(T);
+  auto add = [&](const std::string& op, Result res) {
+    res.op = op;
+    res.type = type;
+    res.size = S;
+    results.push_back(res);
+  };
+  add("small_multiply", Measure(options, [&] {
+        Clobber(lhs);
+        Clobber(rhs);
+        KeepData((lhs * rhs).Data());
+      }, 2.0 * elements * S, 3 * elem_bytes));
+  add("generic_multiply", Measure(options, [&] {
+        Clobber(lhs_heap);
+        Clobber(rhs_heap);
+        std::vector<T> res(S * S, T());
+        Gemm(S, S, S, lhs_heap.data(), S, rhs_heap.data(), S, res.data(), S);
+        KeepData(res.data());
+      }, 2.0 * elements * S, 3 * elem_bytes));
+  add("small_transpose", Measure(options, [&] {
+        Clobber(lhs);
+        KeepData(lhs.Transposed().Data());
+      }, 0, 2 * elem_bytes));
+  add("generic_transpose", Measure(options, [&] {
+        Clobber(lhs_heap);
+        std::vector<T> res(S * S, T());
+        TransposeBlocked(lhs_heap.data(), S, res.data(), S, S, S);
+        KeepData(res.data());
+      }, 0, 2 * elem_bytes));
+}
+
+template <typename T, size_t... Sizes>
+void BenchSmallType(const Options& options, const std::string& type,
+                    std::vector<Result>& results) {
+  (BenchSmall<T, Sizes>(options, type, results), ...);
+}
+
+template <typename T, size_t... Sizes>
+void BenchType(const Options& options, const std::string& type,
+               std::vector<Result>& results) {
+  auto bench = [&](auto size) {
+    if (decltype(size)::value <= options.max_size) {
+      BenchSize<T, decltype(size)::value>(options, type, results);
+    }
+  };
+  (bench(std::integral_constant<size_t, Sizes>{}), ...);
+}
+
+std::string ToJson(const Result& res) {
+  std::ostringstream out;
+  out << "{\"op\": \"" << res.op << "\", \"type\": \"" << res.type
+      << "\", \"size\": " << res.size << ", \"ns_per_call\": "
+      << res.ns_per_call << ", \"gflops\": " << res.gflops
+      << ", \"bytes_per_element\": " << res.bytes_per_element
+      << ", \"allocations_per_call\": " << res.allocations_per_call << "}";
+  return out.str();
+}
+
+std::string JsonField(const std::string& line, const std::string& key) {
+  std::string pattern = "\"" + key + "\": ";
+  size_t pos = line.find(pattern);
+  if (pos == std::string::npos) {
+    return "";
+  }
+  pos += pattern.size();
+  if (line[pos] == '"') {
+    return line.substr(pos + 1, line.find('"', pos + 1) - pos - 1);
+  }
+  return line.substr(pos, line.find_first_of(",}", pos) - pos);
+}
+
+std::vector<Result> ReadJson(const std::string& path) {
+  std::ifstream in(path);
+  if (!in) {
+    std::cerr << "cannot read baseline " << path << "\n";
+    std::exit(2);
+  }
+  std::vector<Result> res;
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.find("\"op\"") == std::string::npos) {
+      continue;
+    }
+    Result result;
+    result.op = JsonField(line, "op");
+    result.type = JsonField(line, "type");
+    result.size = std::stoul(JsonField(line, "size"));
+    result.ns_per_call = std::stod(JsonField(line, "ns_per_call"));
+    res.push_back(result);
+  }
+  return res;
+}
+
+Options ParseOptions(int argc, char** argv) {
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    size_t eq = arg.find('=');
+    std::string key = arg.substr(0, eq);
+    std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+    if (key == "--types") {
+      options.types.clear();
+      std::stringstream list(value);
+      std::string type;
+      while (std::getline(list, type, ',')) {
+        options.types.push_back(type);
+      }
+    } else if (key == "--max-size") {
+      options.max_size = std::stoul(value);
+    } else if (key == "--min-time") {
+      options.min_time = std::stod(value);
+    } else if (key == "--json") {
+      options.json_path = value;
+    } else if (key == "--compare") {
+      options.compare_path = value;
+    } else if (key == "--tolerance") {
+      options.tolerance = std::stod(value);
+    } else {
+      std::cerr << "unknown option " << arg << "\n";
+      std::exit(2);
+    }
+  }
+  return options;
+}
+
+}  // namespace
+
+void* operator new(size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+// GCC cannot see that these pair with the malloc-based operator new above.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, size_t /*unused*/) noexcept { std::free(ptr); }
+#pragma GCC diagnostic pop
+
+int main(int argc, char** argv) {
+  Options options = ParseOptions(argc, argv);
+  std::vector<Result> results;
+  for (const auto& type : options.types) {
+    if (type == "int64") {
+      BenchSmallType<int64_t, 2, 3, 4>(options, type, results);
+      BenchType<int64_t, 4, 16, 64, 256, 1024, 4096>(options, type, results);
+    } else if (type == "double") {
+      BenchSmallType<double, 2, 3, 4>(options, type, results);
+      BenchType<double, 4, 16, 64, 256, 1024, 4096>(options, type, results);
+    } else if (type == "float") {
+      BenchSmallType<float, 2, 3, 4>(options, type, results);
+      BenchType<float, 4, 16, 64, 256, 1024, 4096>(options, type, results);
+    } else {
+      std::cerr << "unknown type " << type << "\n";
+      return 2;
+    }
+  }
+
+  std::printf("%-19s %-7s %6s %14s %9s %11s %8s\n", "op", "type", "size",
+              "ns/call", "GFLOPS", "bytes/elem", "allocs");
+  for (const auto& res : results) {
+    std::printf("%-19s %-7s %6zu %14.1f %9.3f %11.2f %8.2f\n", res.op.c_str(),
+                res.type.c_str(), res.size, res.ns_per_call, res.gflops,
+                res.bytes_per_element, res.allocations_per_call);
+  }
+
+  if (!options.json_path.empty()) {
+    std::ofstream out(options.json_path);
+    out << "[\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+      out << "  " << ToJson(results[i])
+          << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "]\n";
+  }
+
+  int status = 0;
+  if (!options.compare_path.empty()) {
+    for (const auto& base : ReadJson(options.compare_path)) {
+      for (const auto& res : results) {
+        if (res.op != base.op || res.type != base.type ||
+            res.size != base.size) {
+          continue;
+        }
+        double ratio = res.ns_per_call / base.ns_per_call;
+        if (ratio > 1 + options.tolerance) {
+          std::printf("REGRESSION %s %s %zu: %.2fx slower than baseline\n",
+                      res.op.c_str(), res.type.c_str(), res.size, ratio);
+          status = 1;
+        }
+      }
+    }
+  }
+  return status;
+}
@@ -0,0 +1,315 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#include "Matrix.hpp"
+
+// Binary matrix file:
+//   MatrixFileHeader (64 bytes, little endian)
+//   zero padding up to header.data_offset, a multiple of header.alignment
+//   rows * cols elements of header.dtype, row-major, no row padding
+// Because data_offset is aligned and mmap returns page-aligned memory, a
+// mapped file can be read in place as a ConstMatrixView.
+const char kMatrixFileMagic[8] = {'M', 'A', 'T', 'R', 'I', 'X', '\0', '1'};
+const uint64_t kMatrixFileAlignment = 64;
+// Bytes MatrixFileWriter collects before it hands them to write(2).
+const size_t kMatrixFileWriteBuffer = size_t(1) << 20;
+
+enum class MatrixDtype : uint32_t {
+  kInt32 = 1,
+  kInt64 = 2,
+  kUint32 = 3,
+  kUint64 = 4,
+  kFloat32 = 5,
+  kFloat64 = 6,
+};
+
+template <typename T>
+constexpr MatrixDtype MatrixDtypeOf() {
+  if constexpr (std::is_same_v<T, int32_t>) {
+    return MatrixDtype::kInt32;
+  } else if constexpr (std::is_same_v<T, int64_t>) {
+    return MatrixDtype::kInt64;
+  } else if constexpr (std::is_same_v<T, uint32_t>) {
+    return MatrixDtype::kUint32;
+  } else if constexpr (std::is_same_v<T, uint64_t>) {
+    return MatrixDtype::kUint64;
+  } else if constexpr (std::is_same_v<T, float>) {
+    return MatrixDtype::kFloat32;
+  } else {
+    static_assert(std::is_same_v<T, double>,
+                  "Element type has no matrix file dtype");
+    return MatrixDtype::kFloat64;
+  }
+}
+
+struct MatrixFileHeader {
+  char magic[8];
+  uint32_t dtype;
+  uint32_t element_size;
+  uint64_t rows;
+  uint64_t cols;
+  uint64_t alignment;
+  uint64_t data_offset;
+  uint64_t reserved[2];
+};
+
+static_assert(sizeof(MatrixFileHeader) == 64, "Header layout changed");
+
+// Read-only mapping of a matrix file. Owns the mapping; View() is valid for
+// the lifetime of the object.
+template <typename T>
+class MappedMatrix {
+ public:
+  explicit MappedMatrix(const std::string& path);
+  MappedMatrix(const MappedMatrix&) = delete;
+  MappedMatrix& operator=(const MappedMatrix&) = delete;
+  ~MappedMatrix();
+
+  size_t Rows() const;
+  size_t Cols() const;
+  ConstMatrixView<T> View() const;
+
+ private:
+  void* mapping_ = MAP_FAILED;
+  size_t length_ = 0;
+  size_t rows_ = 0;
+  size_t cols_ = 0;
+  const T* data_ = nullptr;
+};
+
+template <typename T>
+MappedMatrix<T>::MappedMatrix(const std::string& path) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::system_error(errno, std::generic_category(), path);
+  }
+  struct stat info {};
+  if (fstat(fd, &info) != 0) {
+    int error = errno;
+    close(fd);
+    throw std::system_error(error, std::generic_category(), path);
+  }
+  length_ = static_cast<size_t>(info.st_size);
+  if (length_ < sizeof(MatrixFileHeader)) {
+    close(fd);
+    throw std::runtime_error("Not a matrix file: " + path);
+  }
+  mapping_ = mmap(nullptr, length_, PROT_READ, MAP_SHARED, fd, 0);
+  int error = errno;
+  close(fd);
+  if (mapping_ == MAP_FAILED) {
+    throw std::system_error(error, std::generic_category(), path);
+  }
+  MatrixFileHeader header;
+  std::memcpy(&header, mapping_, sizeof(header));
+  const char* problem = nullptr;
+  if (std::memcmp(header.magic, kMatrixFileMagic, sizeof(header.magic)) !=
+      0) {
+    problem = "Not a matrix file: ";
+  } else if (header.dtype != static_cast<uint32_t>(MatrixDtypeOf<T>()) ||
+             header.element_size != sizeof(T)) {
+    problem = "Matrix file has a different element type: ";
+  } else if (header.alignment < alignof(T) ||
+             (header.alignment & (header.alignment - 1)) != 0 ||
+             header.alignment > static_cast<uint64_t>(sysconf(_SC_PAGESIZE)) ||
+             header.data_offset < sizeof(MatrixFileHeader) ||
+             header.data_offset % header.alignment != 0) {
+    // The mapping is page-aligned, so data_offset alone decides the
+    // alignment of the elements, and only up to the page size.
+    problem = "Matrix file has a bad layout: ";
+  } else if (header.cols == 0 || header.data_offset > length_ ||
+             (length_ - header.data_offset) / sizeof(T) / header.cols <
+                 header.rows) {
+    problem = "Matrix file is truncated: ";
+  }
+  if (problem != nullptr) {
+    munmap(mapping_, length_);
+    throw std::runtime_error(problem + path);
+  }
+  rows_ = header.rows;
+  cols_ = header.cols;
+  data_ = reinterpret_cast<const T*>(static_cast<const char*>(mapping_) +
+                                     header.data_offset);
+  madvise(mapping_, length_, MADV_WILLNEED);
+}
+
+template <typename T>
+MappedMatrix<T>::~MappedMatrix() {
+  if (mapping_ != MAP_FAILED) {
+    munmap(mapping_, length_);
+  }
+}
+
+template <typename T>
+size_t MappedMatrix<T>::Rows() const {
+  return rows_;
+}
+
+template <typename T>
+size_t MappedMatrix<T>::Cols() const {
+  return cols_;
+}
+
+template <typename T>
+ConstMatrixView<T> MappedMatrix<T>::View() const {
+  return ConstMatrixView<T>(data_, rows_, cols_, cols_);
+}
+
+// Writes a matrix file row by row, so the whole matrix never has to be in
+// memory. Close() checks that every row was written.
+template <typename T>
+class MatrixFileWriter {
+ public:
+  MatrixFileWriter(const std::string& path, size_t rows, size_t cols);
+  MatrixFileWriter(const MatrixFileWriter&) = delete;
+  MatrixFileWriter& operator=(const MatrixFileWriter&) = delete;
+  ~MatrixFileWriter();
+
+  void WriteRow(const T* row);
+  void Write(ConstMatrixView<T> block);
+  void Close();
+
+ private:
+  void Append(const char* data, size_t count);
+  void Flush();
+  void WriteAll(const char* data, size_t count);
+
+  int fd_ = -1;
+  std::vector<char> buffer_;
+  std::string path_;
+  size_t rows_;
+  size_t cols_;
+  size_t written_ = 0;
+};
+
+template <typename T>
+MatrixFileWriter<T>::MatrixFileWriter(const std::string& path, size_t rows,
+                                      size_t cols)
+    : path_(path), rows_(rows), cols_(cols) {
+  // Checked before the file is opened, which truncates it.
+  if (cols == 0) {
+    throw std::invalid_argument("Matrix file needs at least one column");
+  }
+  buffer_.reserve(kMatrixFileWriteBuffer);
+  fd_ = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+  if (fd_ < 0) {
+    throw std::system_error(errno, std::generic_category(), path);
+  }
+  MatrixFileHeader header{};
+  std::memcpy(header.magic, kMatrixFileMagic, sizeof(header.magic));
+  header.dtype = static_cast<uint32_t>(MatrixDtypeOf<T>());
+  header.element_size = sizeof(T);
+  header.rows = rows;
+  header.cols = cols;
+  header.alignment = kMatrixFileAlignment;
+  header.data_offset = kMatrixFileAlignment;
+  buffer_.insert(buffer_.end(), reinterpret_cast<const char*>(&header),
+                 reinterpret_cast<const char*>(&header) + sizeof(header));
+  buffer_.resize(header.data_offset, '\0');
+}
+
+template <typename T>
+MatrixFileWriter<T>::~MatrixFileWriter() {
+  if (fd_ >= 0) {
+    // Errors can only be reported by Close().
+    try {
+      Flush();
+    } catch (const std::system_error&) {
+    }
+    close(fd_);
+  }
+}
+
+template <typename T>
+void MatrixFileWriter<T>::Append(const char* data, size_t count) {
+  if (buffer_.size() + count > kMatrixFileWriteBuffer) {
+    Flush();
+  }
+  if (count >= kMatrixFileWriteBuffer) {
+    WriteAll(data, count);
+    return;
+  }
+  buffer_.insert(buffer_.end(), data, data + count);
+}
+
+template <typename T>
+void MatrixFileWriter<T>::Flush() {
+  WriteAll(buffer_.data(), buffer_.size());
+  buffer_.clear();
+}
+
+template <typename T>
+void MatrixFileWriter<T>::WriteAll(const char* data, size_t count) {
+  size_t done = 0;
+  while (done < count) {
+    ssize_t put = write(fd_, data + done, count - done);
+    if (put < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::system_error(errno, std::generic_category(), path_);
+    }
+    done += static_cast<size_t>(put);
+  }
+}
+
+template <typename T>
+void MatrixFileWriter<T>::WriteRow(const T* row) {
+  if (written_ == rows_) {
+    throw std::out_of_range("Out of range");
+  }
+  Append(reinterpret_cast<const char*>(row), sizeof(T) * cols_);
+  ++written_;
+}
+
+template <typename T>
+void MatrixFileWriter<T>::Write(ConstMatrixView<T> block) {
+  if (block.Cols() != cols_) {
+    throw std::invalid_argument("Matrix shapes differ");
+  }
+  for (size_t i = 0; i < block.Rows(); ++i) {
+    WriteRow(block.Data() + i * block.Stride());
+  }
+}
+
+template <typename T>
+void MatrixFileWriter<T>::Close() {
+  if (fd_ < 0) {
+    return;
+  }
+  int fd = fd_;
+  try {
+    Flush();
+  } catch (...) {
+    fd_ = -1;
+    close(fd);
+    throw;
+  }
+  fd_ = -1;
+  if (close(fd) != 0) {
+    throw std::system_error(errno, std::generic_category(), path_);
+  }
+  if (written_ != rows_) {
+    throw std::runtime_error("Matrix file is incomplete: " + path_);
+  }
+}
+
+template <size_t N, size_t M, typename T>
+void SaveMatrix(const std::string& path, const Matrix<N, M, T>& matrix) {
+  MatrixFileWriter<T> writer(path, N, M);
+  writer.Write(matrix.View());
+  writer.Close();
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+#include "../Parallel/ParallelFor.hpp"
+
+// General matrix multiply over row-major buffers with explicit leading
+// dimensions: c (m x n) += a (m x k) * b (k x n), or -= when Subtract is set.
+// The k dimension is blocked so that the touched rows of b stay in cache, and
+// the innermost loop walks b and c contiguously so it vectorizes. Rows of c are
+// distributed across threads once the product is big enough to pay for them.
+const size_t kGemmBlockK = 128;
+const size_t kGemmBlockRows = 64;
+const size_t kGemmParallelFlops = size_t(1) << 21;
+
+template <bool Subtract = false, typename T>
+void GemmRows(size_t row_begin, size_t row_end, size_t n, size_t k, const T* a,
+              size_t lda, const T* b, size_t ldb, T* c, size_t ldc) {
+  for (size_t kk = 0; kk < k; kk += kGemmBlockK) {
+    size_t k_end = std::min(k, kk + kGemmBlockK);
+    for (size_t i = row_begin; i < row_end; ++i) {
+      T* c_row = c + i * ldc;
+      for (size_t p = kk; p < k_end; ++p) {
+        T elem = a[i * lda + p];
+        const T* b_row = b + p * ldb;
+        for (size_t j = 0; j < n; ++j) {
+          if constexpr (Subtract) {
+            c_row[j] -= elem * b_row[j];
+          } else {
+            c_row[j] += elem * b_row[j];
+          }
+        }
+      }
+    }
+  }
+}
+
+template <bool Subtract = false, typename T>
+void Gemm(size_t m, size_t n, size_t k, const T* a, size_t lda, const T* b,
+          size_t ldb, T* c, size_t ldc) {
+  if (m * n * k < kGemmParallelFlops) {
+    GemmRows<Subtract>(0, m, n, k, a, lda, b, ldb, c, ldc);
+    return;
+  }
+  ParallelFor(0, m, kGemmBlockRows, [=](size_t begin, size_t end) {
+    GemmRows<Subtract>(begin, end, n, k, a, lda, b, ldb, c, ldc);
+  });
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+
+#include "../Parallel/ParallelFor.hpp"
+#include "Matrix.hpp"
+#include "MatrixSimd.hpp"
+
+// Level-2 kernels on views. Each one reads the matrix exactly once, row by
+// row, and splits the work across threads once the matrix is large enough:
+// Gemv and Ger by rows, GemvTransposed by column slabs so that no thread has
+// to reduce partial results of another.
+const size_t kGemvParallelElements = size_t(1) << 18;
+const size_t kGemvBlockRows = 64;
+const size_t kGemvBlockCols = 256;
+
+template <typename T>
+T Dot(const T* lhs, const T* rhs, size_t size) {
+  if constexpr (kHasSimdDot<T>) {
+    return DotSimd(lhs, rhs, size);
+  } else {
+    T res = T();
+    for (size_t i = 0; i < size; ++i) {
+      res += lhs[i] * rhs[i];
+    }
+    return res;
+  }
+}
+
+// y = a * x; x has a.Cols() entries, y has a.Rows().
+template <typename T>
+void Gemv(std::type_identity_t<ConstMatrixView<T>> a, const T* x, T* y) {
+  auto rows = [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      y[i] = Dot(a.Data() + i * a.Stride(), x, a.Cols());
+    }
+  };
+  if (a.Rows() * a.Cols() < kGemvParallelElements) {
+    rows(0, a.Rows());
+  } else {
+    ParallelFor(0, a.Rows(), kGemvBlockRows, rows);
+  }
+}
+
+// y = transpose(a) * x; x has a.Rows() entries, y has a.Cols().
+template <typename T>
+void GemvTransposed(std::type_identity_t<ConstMatrixView<T>> a, const T* x,
+                    T* y) {
+  auto cols = [&](size_t begin, size_t end) {
+    std::fill(y + begin, y + end, T());
+    for (size_t i = 0; i < a.Rows(); ++i) {
+      const T* row = a.Data() + i * a.Stride();
+      T factor = x[i];
+      for (size_t j = begin; j < end; ++j) {
+        y[j] += factor * row[j];
+      }
+    }
+  };
+  if (a.Rows() * a.Cols() < kGemvParallelElements) {
+    cols(0, a.Cols());
+  } else {
+    ParallelFor(0, a.Cols(), kGemvBlockCols, cols);
+  }
+}
+
+// Rank-1 update a += x * transpose(y); x has a.Rows() entries, y a.Cols().
+template <typename T>
+void Ger(MatrixView<T> a, const T* x, const T* y) {
+  auto rows = [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      T* row = a.Data() + i * a.Stride();
+      T factor = x[i];
+      for (size_t j = 0; j < a.Cols(); ++j) {
+        row[j] += factor * y[j];
+      }
+    }
+  };
+  if (a.Rows() * a.Cols() < kGemvParallelElements) {
+    rows(0, a.Rows());
+  } else {
+    ParallelFor(0, a.Rows(), kGemvBlockRows, rows);
+  }
+}
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Matrix.hpp"
+#include "MatrixGemm.hpp"
+
+// Blocked right-looking LU factorization with partial pivoting, P * A = L * U.
+// Each step factors a kLuBlock-wide panel, solves for the matching block row
+// of U and then updates the trailing submatrix with one Gemm call, so the
+// O(n^3) part of the work runs in the multithreaded multiply kernel.
+const size_t kLuBlock = 64;
+
+template <size_t N, typename T>
+class LuDecomposition {
+  static_assert(std::is_floating_point_v<T>,
+                "LU decomposition needs a floating point element type");
+
+ public:
+  explicit LuDecomposition(const Matrix<N, N, T>& matrix);
+
+  bool IsSingular() const;
+  T Determinant() const;
+  template <size_t R>
+  Matrix<N, R, T> Solve(const Matrix<N, R, T>& rhs) const;
+  Matrix<N, N, T> Inverse() const;
+
+ private:
+  void FactorPanel(size_t begin, size_t end);
+
+  Matrix<N, N, T> lu_;
+  std::vector<size_t> pivots_ = std::vector<size_t>(N);
+  bool odd_swaps_ = false;
+  bool singular_ = false;
+};
+
+template <size_t N, typename T>
+LuDecomposition<N, T>::LuDecomposition(const Matrix<N, N, T>& matrix)
+    : lu_(matrix) {
+  T* a = lu_.Data();
+  for (size_t j = 0; j < N; j += kLuBlock) {
+    size_t end = std::min(N, j + kLuBlock);
+    FactorPanel(j, end);
+    // U12 = L11^-1 * A12, row by row so the inner loop is contiguous.
+    for (size_t r = j + 1; r < end; ++r) {
+      for (size_t c = j; c < r; ++c) {
+        T factor = a[r * N + c];
+        for (size_t q = end; q < N; ++q) {
+          a[r * N + q] -= factor * a[c * N + q];
+        }
+      }
+    }
+    // A22 -= L21 * U12.
+    Gemm<true>(N - end, N - end, end - j, a + end * N + j, N, a + j * N + end,
+               N, a + end * N + end, N);
+  }
+}
+
+template <size_t N, typename T>
+void LuDecomposition<N, T>::FactorPanel(size_t begin, size_t end) {
+  T* a = lu_.Data();
+  for (size_t c = begin; c < end; ++c) {
+    size_t pivot = c;
+    for (size_t r = c + 1; r < N; ++r) {
+      if (std::abs(a[r * N + c]) > std::abs(a[pivot * N + c])) {
+        pivot = r;
+      }
+    }
+    pivots_[c] = pivot;
+    if (a[pivot * N + c] == T(0)) {
+      singular_ = true;
+      continue;
+    }
+    if (pivot != c) {
+      std::swap_ranges(a + c * N, a + (c + 1) * N, a + pivot * N);
+      odd_swaps_ = !odd_swaps_;
+    }
+    T inverse = T(1) / a[c * N + c];
+    for (size_t r = c + 1; r < N; ++r) {
+      T factor = a[r * N + c] *= inverse;
+      for (size_t q = c + 1; q < end; ++q) {
+        a[r * N + q] -= factor * a[c * N + q];
+      }
+    }
+  }
+}
+
+template <size_t N, typename T>
+bool LuDecomposition<N, T>::IsSingular() const {
+  return singular_;
+}
+
+template <size_t N, typename T>
+T LuDecomposition<N, T>::Determinant() const {
+  if (singular_) {
+    return T(0);
+  }
+  T res = odd_swaps_ ? T(-1) : T(1);
+  for (size_t i = 0; i < N; ++i) {
+    res *= lu_(i, i);
+  }
+  return res;
+}
+
+template <size_t N, typename T>
+template <size_t R>
+Matrix<N, R, T> LuDecomposition<N, T>::Solve(
+    const Matrix<N, R, T>& rhs) const {
+  if (singular_) {
+    throw std::invalid_argument("Matrix is singular");
+  }
+  Matrix<N, R, T> res = rhs;
+  T* x = res.Data();
+  const T* a = lu_.Data();
+  for (size_t i = 0; i < N; ++i) {
+    if (pivots_[i] != i) {
+      std::swap_ranges(x + i * R, x + (i + 1) * R, x + pivots_[i] * R);
+    }
+  }
+  for (size_t i = 0; i < N; ++i) {
+    for (size_t k = 0; k < i; ++k) {
+      T factor = a[i * N + k];
+      for (size_t j = 0; j < R; ++j) {
+        x[i * R + j] -= factor * x[k * R + j];
+      }
+    }
+  }
+  for (size_t i = N; i-- > 0;) {
+    for (size_t k = i + 1; k < N; ++k) {
+      T factor = a[i * N + k];
+      for (size_t j = 0; j < R; ++j) {
+        x[i * R + j] -= factor * x[k * R + j];
+      }
+    }
+    T inverse = T(1) / a[i * N + i];
+    for (size_t j = 0; j < R; ++j) {
+      x[i * R + j] *= inverse;
+    }
+  }
+  return res;
+}
+
+template <size_t N, typename T>
+Matrix<N, N, T> LuDecomposition<N, T>::Inverse() const {
+  Matrix<N, N, T> identity;
+  for (size_t i = 0; i < N; ++i) {
+    identity(i, i) = T(1);
+  }
+  return Solve(identity);
+}
+
+template <size_t N, size_t M, typename T>
+template <size_t R>
+Matrix<N, R, T> Matrix<N, M, T>::Solve(const Matrix<N, R, T>& rhs) const {
+  static_assert(N == M, "Solve needs a square matrix");
+  return LuDecomposition<N, T>(*this).Solve(rhs);
+}
+
+template <size_t N, size_t M, typename T>
+Matrix<N, M, T> Matrix<N, M, T>::Inverse() const {
+  static_assert(N == M, "Inverse is defined for square matrices only");
+  return LuDecomposition<N, T>(*this).Inverse();
+}
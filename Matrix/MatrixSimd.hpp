@@ -0,0 +1,193 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+#if defined(__SSE__)
+#include <immintrin.h>
+#endif
+
+// Hand-written kernels for 4x4 row-major float/double products. Each row of
+// the result is a linear combination of the rows of the right operand, so one
+// row fits into a single SSE (float) or AVX (double) register.
+
+template <typename T>
+constexpr bool kHasSimd4x4 =
+#if defined(__SSE__)
+    std::is_same_v<T, float> ||
+#endif
+#if defined(__AVX__)
+    std::is_same_v<T, double> ||
+#endif
+    false;
+
+#if defined(__SSE__)
+inline void Multiply4x4Simd(const float* lhs, const float* rhs, float* res) {
+  __m128 row0 = _mm_loadu_ps(rhs);
+  __m128 row1 = _mm_loadu_ps(rhs + 4);
+  __m128 row2 = _mm_loadu_ps(rhs + 8);
+  __m128 row3 = _mm_loadu_ps(rhs + 12);
+  for (size_t i = 0; i < 4; ++i) {
+    __m128 sum = _mm_mul_ps(_mm_set1_ps(lhs[i * 4]), row0);
+    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(lhs[i * 4 + 1]), row1));
+    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(lhs[i * 4 + 2]), row2));
+    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(lhs[i * 4 + 3]), row3));
+    _mm_storeu_ps(res + i * 4, sum);
+  }
+}
+#endif
+
+#if defined(__AVX__)
+inline void Multiply4x4Simd(const double* lhs, const double* rhs,
+                            double* res) {
+  __m256d row0 = _mm256_loadu_pd(rhs);
+  __m256d row1 = _mm256_loadu_pd(rhs + 4);
+  __m256d row2 = _mm256_loadu_pd(rhs + 8);
+  __m256d row3 = _mm256_loadu_pd(rhs + 12);
+  for (size_t i = 0; i < 4; ++i) {
+    __m256d sum = _mm256_mul_pd(_mm256_set1_pd(lhs[i * 4]), row0);
+    sum = _mm256_add_pd(sum,
+                        _mm256_mul_pd(_mm256_set1_pd(lhs[i * 4 + 1]), row1));
+    sum = _mm256_add_pd(sum,
+                        _mm256_mul_pd(_mm256_set1_pd(lhs[i * 4 + 2]), row2));
+    sum = _mm256_add_pd(sum,
+                        _mm256_mul_pd(_mm256_set1_pd(lhs[i * 4 + 3]), row3));
+    _mm256_storeu_pd(res + i * 4, sum);
+  }
+}
+#endif
+
+// In-register tile transposes used by the blocked transpose. kSimdTransposeTile
+// is the tile edge handled by one call, or 0 when T has no SIMD kernel.
+template <typename T>
+constexpr size_t kSimdTransposeTile =
+#if defined(__AVX__)
+    std::is_same_v<T, float> ? 8 : std::is_same_v<T, double> ? 4 : 0;
+#elif defined(__SSE__)
+    std::is_same_v<T, float> ? 4 : 0;
+#else
+    0;
+#endif
+
+#if defined(__AVX__)
+inline void TransposeTileSimd(const float* src, size_t src_stride, float* dst,
+                              size_t dst_stride) {
+  __m256 r0 = _mm256_loadu_ps(src);
+  __m256 r1 = _mm256_loadu_ps(src + src_stride);
+  __m256 r2 = _mm256_loadu_ps(src + 2 * src_stride);
+  __m256 r3 = _mm256_loadu_ps(src + 3 * src_stride);
+  __m256 r4 = _mm256_loadu_ps(src + 4 * src_stride);
+  __m256 r5 = _mm256_loadu_ps(src + 5 * src_stride);
+  __m256 r6 = _mm256_loadu_ps(src + 6 * src_stride);
+  __m256 r7 = _mm256_loadu_ps(src + 7 * src_stride);
+  __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+  __m256 t1 = _mm256_unpackhi_ps(r0, r1);
+  __m256 t2 = _mm256_unpacklo_ps(r2, r3);
+  __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+  __m256 t4 = _mm256_unpacklo_ps(r4, r5);
+  __m256 t5 = _mm256_unpackhi_ps(r4, r5);
+  __m256 t6 = _mm256_unpacklo_ps(r6, r7);
+  __m256 t7 = _mm256_unpackhi_ps(r6, r7);
+  r0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+  r1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+  r2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+  r3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+  r4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+  r5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+  r6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+  r7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+  _mm256_storeu_ps(dst, _mm256_permute2f128_ps(r0, r4, 0x20));
+  _mm256_storeu_ps(dst + dst_stride, _mm256_permute2f128_ps(r1, r5, 0x20));
+  _mm256_storeu_ps(dst + 2 * dst_stride, _mm256_permute2f128_ps(r2, r6, 0x20));
+  _mm256_storeu_ps(dst + 3 * dst_stride, _mm256_permute2f128_ps(r3, r7, 0x20));
+  _mm256_storeu_ps(dst + 4 * dst_stride, _mm256_permute2f128_ps(r0, r4, 0x31));
+  _mm256_storeu_ps(dst + 5 * dst_stride, _mm256_permute2f128_ps(r1, r5, 0x31));
+  _mm256_storeu_ps(dst + 6 * dst_stride, _mm256_permute2f128_ps(r2, r6, 0x31));
+  _mm256_storeu_ps(dst + 7 * dst_stride, _mm256_permute2f128_ps(r3, r7, 0x31));
+}
+
+inline void TransposeTileSimd(const double* src, size_t src_stride,
+                              double* dst, size_t dst_stride) {
+  __m256d r0 = _mm256_loadu_pd(src);
+  __m256d r1 = _mm256_loadu_pd(src + src_stride);
+  __m256d r2 = _mm256_loadu_pd(src + 2 * src_stride);
+  __m256d r3 = _mm256_loadu_pd(src + 3 * src_stride);
+  __m256d t0 = _mm256_unpacklo_pd(r0, r1);
+  __m256d t1 = _mm256_unpackhi_pd(r0, r1);
+  __m256d t2 = _mm256_unpacklo_pd(r2, r3);
+  __m256d t3 = _mm256_unpackhi_pd(r2, r3);
+  _mm256_storeu_pd(dst, _mm256_permute2f128_pd(t0, t2, 0x20));
+  _mm256_storeu_pd(dst + dst_stride, _mm256_permute2f128_pd(t1, t3, 0x20));
+  _mm256_storeu_pd(dst + 2 * dst_stride, _mm256_permute2f128_pd(t0, t2, 0x31));
+  _mm256_storeu_pd(dst + 3 * dst_stride, _mm256_permute2f128_pd(t1, t3, 0x31));
+}
+#elif defined(__SSE__)
+inline void TransposeTileSimd(const float* src, size_t src_stride, float* dst,
+                              size_t dst_stride) {
+  __m128 r0 = _mm_loadu_ps(src);
+  __m128 r1 = _mm_loadu_ps(src + src_stride);
+  __m128 r2 = _mm_loadu_ps(src + 2 * src_stride);
+  __m128 r3 = _mm_loadu_ps(src + 3 * src_stride);
+  _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+  _mm_storeu_ps(dst, r0);
+  _mm_storeu_ps(dst + dst_stride, r1);
+  _mm_storeu_ps(dst + 2 * dst_stride, r2);
+  _mm_storeu_ps(dst + 3 * dst_stride, r3);
+}
+#endif
+
+// Dot products for GEMV. Floating point reductions are not vectorized by the
+// compiler without -ffast-math, so the lanes are summed explicitly here.
+template <typename T>
+constexpr bool kHasSimdDot =
+#if defined(__AVX__)
+    std::is_same_v<T, float> || std::is_same_v<T, double>;
+#else
+    false;
+#endif
+
+#if defined(__AVX__)
+inline float DotSimd(const float* lhs, const float* rhs, size_t size) {
+  __m256 sum0 = _mm256_setzero_ps();
+  __m256 sum1 = _mm256_setzero_ps();
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    sum0 = _mm256_add_ps(sum0, _mm256_mul_ps(_mm256_loadu_ps(lhs + i),
+                                             _mm256_loadu_ps(rhs + i)));
+    sum1 = _mm256_add_ps(sum1, _mm256_mul_ps(_mm256_loadu_ps(lhs + i + 8),
+                                             _mm256_loadu_ps(rhs + i + 8)));
+  }
+  alignas(32) float lanes[8];
+  _mm256_store_ps(lanes, _mm256_add_ps(sum0, sum1));
+  float res = 0;
+  for (float lane : lanes) {
+    res += lane;
+  }
+  for (; i < size; ++i) {
+    res += lhs[i] * rhs[i];
+  }
+  return res;
+}
+
+inline double DotSimd(const double* lhs, const double* rhs, size_t size) {
+  __m256d sum0 = _mm256_setzero_pd();
+  __m256d sum1 = _mm256_setzero_pd();
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    sum0 = _mm256_add_pd(sum0, _mm256_mul_pd(_mm256_loadu_pd(lhs + i),
+                                             _mm256_loadu_pd(rhs + i)));
+    sum1 = _mm256_add_pd(sum1, _mm256_mul_pd(_mm256_loadu_pd(lhs + i + 4),
+                                             _mm256_loadu_pd(rhs + i + 4)));
+  }
+  alignas(32) double lanes[4];
+  _mm256_store_pd(lanes, _mm256_add_pd(sum0, sum1));
+  double res = 0;
+  for (double lane : lanes) {
+    res += lane;
+  }
+  for (; i < size; ++i) {
+    res += lhs[i] * rhs[i];
+  }
+  return res;
+}
+#endif
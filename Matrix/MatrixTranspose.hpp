@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+
+#include "MatrixSimd.hpp"
+
+// Cache-oblivious transpose kernels over row-major buffers with explicit
+// strides. The longer side is halved until a block fits into
+// kTransposeLeaf x kTransposeLeaf, so at some recursion depth both the source
+// and the destination block stay in cache regardless of its size. Leaves are
+// covered by in-register SIMD tiles where available.
+const size_t kTransposeLeaf = 32;
+
+template <typename T>
+void TransposeLeaf(const T* src, size_t src_stride, T* dst, size_t dst_stride,
+                   size_t rows, size_t cols) {
+  size_t i = 0;
+  if constexpr (kSimdTransposeTile<T> != 0) {
+    const size_t kTile = kSimdTransposeTile<T>;
+    for (; i + kTile <= rows; i += kTile) {
+      size_t j = 0;
+      for (; j + kTile <= cols; j += kTile) {
+        TransposeTileSimd(src + i * src_stride + j, src_stride,
+                          dst + j * dst_stride + i, dst_stride);
+      }
+      for (; j < cols; ++j) {
+        for (size_t k = i; k < i + kTile; ++k) {
+          dst[j * dst_stride + k] = src[k * src_stride + j];
+        }
+      }
+    }
+  }
+  for (; i < rows; ++i) {
+    for (size_t j = 0; j < cols; ++j) {
+      dst[j * dst_stride + i] = src[i * src_stride + j];
+    }
+  }
+}
+
+// dst (cols x rows) = transpose of src (rows x cols).
+template <typename T>
+void TransposeBlocked(const T* src, size_t src_stride, T* dst,
+                      size_t dst_stride, size_t rows, size_t cols) {
+  if (rows <= kTransposeLeaf && cols <= kTransposeLeaf) {
+    TransposeLeaf(src, src_stride, dst, dst_stride, rows, cols);
+    return;
+  }
+  if (rows >= cols) {
+    size_t half = rows / 2;
+    TransposeBlocked(src, src_stride, dst, dst_stride, half, cols);
+    TransposeBlocked(src + half * src_stride, src_stride, dst + half,
+                     dst_stride, rows - half, cols);
+  } else {
+    size_t half = cols / 2;
+    TransposeBlocked(src, src_stride, dst, dst_stride, rows, half);
+    TransposeBlocked(src + half, src_stride, dst + half * dst_stride,
+                     dst_stride, rows, cols - half);
+  }
+}
+
+// Swaps the rows x cols block at upper with the transpose of the cols x rows
+// block at lower; both live in the same matrix with the given stride.
+template <typename T>
+void SwapTransposedBlocks(T* upper, T* lower, size_t stride, size_t rows,
+                          size_t cols) {
+  if (rows <= kTransposeLeaf && cols <= kTransposeLeaf) {
+    T buffer[kTransposeLeaf * kTransposeLeaf];
+    TransposeLeaf(upper, stride, buffer, kTransposeLeaf, rows, cols);
+    TransposeLeaf(lower, stride, upper, stride, cols, rows);
+    for (size_t j = 0; j < cols; ++j) {
+      for (size_t i = 0; i < rows; ++i) {
+        lower[j * stride + i] = buffer[j * kTransposeLeaf + i];
+      }
+    }
+    return;
+  }
+  if (rows >= cols) {
+    size_t half = rows / 2;
+    SwapTransposedBlocks(upper, lower, stride, half, cols);
+    SwapTransposedBlocks(upper + half * stride, lower + half, stride,
+                         rows - half, cols);
+  } else {
+    size_t half = cols / 2;
+    SwapTransposedBlocks(upper, lower, stride, rows, half);
+    SwapTransposedBlocks(upper + half, lower + half * stride, stride, rows,
+                         cols - half);
+  }
+}
+
+// Transposes the size x size block at data in place.
+template <typename T>
+void TransposeSquareInPlace(T* data, size_t stride, size_t size) {
+  if (size <= kTransposeLeaf) {
+    for (size_t i = 0; i < size; ++i) {
+      for (size_t j = i + 1; j < size; ++j) {
+        std::swap(data[i * stride + j], data[j * stride + i]);
+      }
+    }
+    return;
+  }
+  size_t half = size / 2;
+  TransposeSquareInPlace(data, stride, half);
+  TransposeSquareInPlace(data + half * stride + half, stride, size - half);
+  SwapTransposedBlocks(data + half, data + half * stride, stride, half,
+                       size - half);
+}
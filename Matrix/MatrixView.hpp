@@ -0,0 +1,195 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+
+#include "Matrix.hpp"
+#include "MatrixGemm.hpp"
+#include "MatrixTranspose.hpp"
+
+// Non-owning window into row-major storage: rows x cols elements starting at
+// data, with consecutive rows stride elements apart. Rows, columns and blocks
+// of a Matrix are all views of this kind, so blocked algorithms can work on
+// sub-regions without copying. ConstMatrixView<T> (declared in Matrix.hpp as
+// MatrixView<const T>) is the read-only flavour.
+template <typename T>
+class MatrixView {
+ public:
+  MatrixView() = default;
+  MatrixView(T* data, size_t rows, size_t cols, size_t stride);
+  template <typename U,
+            typename = std::enable_if_t<std::is_same_v<const U, T> &&
+                                        !std::is_same_v<U, T>>>
+  MatrixView(const MatrixView<U>& view);
+
+  size_t Rows() const;
+  size_t Cols() const;
+  size_t Stride() const;
+  T* Data() const;
+
+  T& operator()(size_t row, size_t column) const;
+
+  MatrixView<T> Block(size_t row, size_t column, size_t rows,
+                      size_t cols) const;
+  MatrixView<T> Row(size_t row) const;
+  MatrixView<T> Column(size_t column) const;
+
+ private:
+  T* data_ = nullptr;
+  size_t rows_ = 0;
+  size_t cols_ = 0;
+  size_t stride_ = 0;
+};
+
+template <typename T>
+MatrixView<T>::MatrixView(T* data, size_t rows, size_t cols, size_t stride)
+    : data_(data), rows_(rows), cols_(cols), stride_(stride) {}
+
+template <typename T>
+template <typename U, typename>
+MatrixView<T>::MatrixView(const MatrixView<U>& view)
+    : MatrixView(view.Data(), view.Rows(), view.Cols(), view.Stride()) {}
+
+template <typename T>
+size_t MatrixView<T>::Rows() const {
+  return rows_;
+}
+
+template <typename T>
+size_t MatrixView<T>::Cols() const {
+  return cols_;
+}
+
+template <typename T>
+size_t MatrixView<T>::Stride() const {
+  return stride_;
+}
+
+template <typename T>
+T* MatrixView<T>::Data() const {
+  return data_;
+}
+
+template <typename T>
+T& MatrixView<T>::operator()(size_t row, size_t column) const {
+  return data_[row * stride_ + column];
+}
+
+template <typename T>
+MatrixView<T> MatrixView<T>::Block(size_t row, size_t column, size_t rows,
+                                   size_t cols) const {
+  if (row + rows > rows_ || column + cols > cols_) {
+    throw std::out_of_range("Out of range");
+  }
+  return MatrixView<T>(data_ + row * stride_ + column, rows, cols, stride_);
+}
+
+template <typename T>
+MatrixView<T> MatrixView<T>::Row(size_t row) const {
+  return Block(row, 0, 1, cols_);
+}
+
+template <typename T>
+MatrixView<T> MatrixView<T>::Column(size_t column) const {
+  return Block(0, column, rows_, 1);
+}
+
+// res = lhs + rhs.
+template <typename T>
+void Add(std::type_identity_t<ConstMatrixView<T>> lhs,
+         std::type_identity_t<ConstMatrixView<T>> rhs, MatrixView<T> res) {
+  if (lhs.Rows() != rhs.Rows() || lhs.Cols() != rhs.Cols() ||
+      lhs.Rows() != res.Rows() || lhs.Cols() != res.Cols()) {
+    throw std::invalid_argument("Matrix shapes differ");
+  }
+  for (size_t i = 0; i < res.Rows(); ++i) {
+    const T* lhs_row = lhs.Data() + i * lhs.Stride();
+    const T* rhs_row = rhs.Data() + i * rhs.Stride();
+    T* res_row = res.Data() + i * res.Stride();
+    for (size_t j = 0; j < res.Cols(); ++j) {
+      res_row[j] = lhs_row[j] + rhs_row[j];
+    }
+  }
+}
+
+// res = lhs * rhs through the shared Gemm kernel.
+template <typename T>
+void Multiply(std::type_identity_t<ConstMatrixView<T>> lhs,
+              std::type_identity_t<ConstMatrixView<T>> rhs, MatrixView<T> res) {
+  if (lhs.Cols() != rhs.Rows() || lhs.Rows() != res.Rows() ||
+      rhs.Cols() != res.Cols()) {
+    throw std::invalid_argument("Matrix shapes differ");
+  }
+  for (size_t i = 0; i < res.Rows(); ++i) {
+    T* res_row = res.Data() + i * res.Stride();
+    std::fill(res_row, res_row + res.Cols(), T());
+  }
+  Gemm(lhs.Rows(), rhs.Cols(), lhs.Cols(), lhs.Data(), lhs.Stride(),
+       rhs.Data(), rhs.Stride(), res.Data(), res.Stride());
+}
+
+// res = transpose of matrix through the blocked transpose kernel.
+template <typename T>
+void Transpose(std::type_identity_t<ConstMatrixView<T>> matrix,
+               MatrixView<T> res) {
+  if (matrix.Rows() != res.Cols() || matrix.Cols() != res.Rows()) {
+    throw std::invalid_argument("Matrix shapes differ");
+  }
+  TransposeBlocked(matrix.Data(), matrix.Stride(), res.Data(), res.Stride(),
+                   matrix.Rows(), matrix.Cols());
+}
+
+template <size_t N, size_t M, typename T>
+Matrix<N, M, T>::Matrix(ConstMatrixView<T> view) {
+  if (view.Rows() != N || view.Cols() != M) {
+    throw std::invalid_argument("Matrix shapes differ");
+  }
+  for (size_t i = 0; i < N; ++i) {
+    std::copy(view.Data() + i * view.Stride(),
+              view.Data() + i * view.Stride() + M, this->Data() + i * M);
+  }
+}
+
+template <size_t N, size_t M, typename T>
+MatrixView<T> Matrix<N, M, T>::View() {
+  return MatrixView<T>(this->Data(), N, M, M);
+}
+
+template <size_t N, size_t M, typename T>
+ConstMatrixView<T> Matrix<N, M, T>::View() const {
+  return ConstMatrixView<T>(this->Data(), N, M, M);
+}
+
+template <size_t N, size_t M, typename T>
+MatrixView<T> Matrix<N, M, T>::Block(size_t row, size_t column, size_t rows,
+                                     size_t cols) {
+  return View().Block(row, column, rows, cols);
+}
+
+template <size_t N, size_t M, typename T>
+ConstMatrixView<T> Matrix<N, M, T>::Block(size_t row, size_t column,
+                                          size_t rows, size_t cols) const {
+  return View().Block(row, column, rows, cols);
+}
+
+template <size_t N, size_t M, typename T>
+MatrixView<T> Matrix<N, M, T>::Row(size_t row) {
+  return View().Row(row);
+}
+
+template <size_t N, size_t M, typename T>
+ConstMatrixView<T> Matrix<N, M, T>::Row(size_t row) const {
+  return View().Row(row);
+}
+
+template <size_t N, size_t M, typename T>
+MatrixView<T> Matrix<N, M, T>::Column(size_t column) {
+  return View().Column(column);
+}
+
+template <size_t N, size_t M, typename T>
+ConstMatrixView<T> Matrix<N, M, T>::Column(size_t column) const {
+  return View().Column(column);
+}
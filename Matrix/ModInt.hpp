@@ -0,0 +1,212 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+
+#include "MatrixGemm.hpp"
+
+// Integer modulo a compile-time P < 2^31. Values are kept canonical in
+// [0, P), and products are reduced with Barrett's method (one 128-bit multiply
+// by a precomputed 2^64 / P and at most one correction) instead of a hardware
+// division.
+template <uint32_t P>
+class ModInt {
+  static_assert(P > 1 && P < (uint32_t(1) << 31),
+                "Modulus must fit into 31 bits");
+
+ public:
+  static constexpr uint64_t kBarrett =
+      static_cast<uint64_t>((static_cast<unsigned __int128>(1) << 64) / P);
+  // How many raw products can be summed in 64 bits before a reduction.
+  static constexpr uint64_t kDelayedProducts =
+      ~uint64_t(0) / (uint64_t(P - 1) * (P - 1));
+
+  constexpr ModInt() = default;
+  constexpr ModInt(int64_t value);
+
+  constexpr uint32_t Value() const;
+  static constexpr uint32_t Reduce(uint64_t value);
+
+  constexpr ModInt<P> operator+(const ModInt<P>& other) const;
+  constexpr ModInt<P> operator-(const ModInt<P>& other) const;
+  constexpr ModInt<P> operator*(const ModInt<P>& other) const;
+  constexpr ModInt<P> operator/(const ModInt<P>& other) const;
+  constexpr ModInt<P> operator-() const;
+  constexpr ModInt<P>& operator+=(const ModInt<P>& other);
+  constexpr ModInt<P>& operator-=(const ModInt<P>& other);
+  constexpr ModInt<P>& operator*=(const ModInt<P>& other);
+  constexpr ModInt<P>& operator/=(const ModInt<P>& other);
+
+  constexpr bool operator==(const ModInt<P>& other) const;
+  constexpr bool operator!=(const ModInt<P>& other) const;
+
+  constexpr ModInt<P> Pow(uint64_t exponent) const;
+  // Multiplicative inverse by Fermat's little theorem, so P must be prime.
+  constexpr ModInt<P> Inverse() const;
+
+ private:
+  uint32_t value_ = 0;
+};
+
+template <uint32_t P>
+constexpr ModInt<P>::ModInt(int64_t value) {
+  int64_t res = value % static_cast<int64_t>(P);
+  value_ = static_cast<uint32_t>(res < 0 ? res + P : res);
+}
+
+template <uint32_t P>
+constexpr uint32_t ModInt<P>::Value() const {
+  return value_;
+}
+
+template <uint32_t P>
+constexpr uint32_t ModInt<P>::Reduce(uint64_t value) {
+  uint64_t quotient = static_cast<uint64_t>(
+      (static_cast<unsigned __int128>(value) * kBarrett) >> 64);
+  uint64_t res = value - quotient * P;
+  return static_cast<uint32_t>(res >= P ? res - P : res);
+}
+
+template <uint32_t P>
+constexpr ModInt<P> ModInt<P>::operator+(const ModInt<P>& other) const {
+  ModInt<P> res = *this;
+  res += other;
+  return res;
+}
+
+template <uint32_t P>
+constexpr ModInt<P> ModInt<P>::operator-(const ModInt<P>& other) const {
+  ModInt<P> res = *this;
+  res -= other;
+  return res;
+}
+
+template <uint32_t P>
+constexpr ModInt<P> ModInt<P>::operator*(const ModInt<P>& other) const {
+  ModInt<P> res = *this;
+  res *= other;
+  return res;
+}
+
+template <uint32_t P>
+constexpr ModInt<P> ModInt<P>::operator/(const ModInt<P>& other) const {
+  return *this * other.Inverse();
+}
+
+template <uint32_t P>
+constexpr ModInt<P> ModInt<P>::operator-() const {
+  ModInt<P> res;
+  res.value_ = value_ == 0 ? 0 : P - value_;
+  return res;
+}
+
+template <uint32_t P>
+constexpr ModInt<P>& ModInt<P>::operator+=(const ModInt<P>& other) {
+  value_ += other.value_;
+  if (value_ >= P) {
+    value_ -= P;
+  }
+  return *this;
+}
+
+template <uint32_t P>
+constexpr ModInt<P>& ModInt<P>::operator-=(const ModInt<P>& other) {
+  value_ = value_ >= other.value_ ? value_ - other.value_
+                                  : value_ + P - other.value_;
+  return *this;
+}
+
+template <uint32_t P>
+constexpr ModInt<P>& ModInt<P>::operator*=(const ModInt<P>& other) {
+  value_ = Reduce(static_cast<uint64_t>(value_) * other.value_);
+  return *this;
+}
+
+template <uint32_t P>
+constexpr ModInt<P>& ModInt<P>::operator/=(const ModInt<P>& other) {
+  return *this *= other.Inverse();
+}
+
+template <uint32_t P>
+constexpr bool ModInt<P>::operator==(const ModInt<P>& other) const {
+  return value_ == other.value_;
+}
+
+template <uint32_t P>
+constexpr bool ModInt<P>::operator!=(const ModInt<P>& other) const {
+  return value_ != other.value_;
+}
+
+template <uint32_t P>
+constexpr ModInt<P> ModInt<P>::Pow(uint64_t exponent) const {
+  ModInt<P> res = 1;
+  ModInt<P> base = *this;
+  while (exponent != 0) {
+    if ((exponent & 1) != 0) {
+      res *= base;
+    }
+    base *= base;
+    exponent >>= 1;
+  }
+  return res;
+}
+
+template <uint32_t P>
+constexpr ModInt<P> ModInt<P>::Inverse() const {
+  return Pow(P - 2);
+}
+
+template <uint32_t P>
+std::ostream& operator<<(std::ostream& ostream, const ModInt<P>& number) {
+  ostream << number.Value();
+  return ostream;
+}
+
+// Columns of C that the ModInt GemmRows below accumulates at once, in a
+// block on the stack.
+const size_t kGemmModTile = 256;
+
+// Delayed-reduction kernel picked up by Gemm for ModInt elements: raw 32x32-bit
+// products are summed into 64-bit accumulators and reduced only once every
+// kDelayedProducts terms instead of after every multiply-add. The
+// accumulators cover kGemmModTile columns at a time, so no call allocates.
+template <bool Subtract, uint32_t P>
+void GemmRows(size_t row_begin, size_t row_end, size_t n, size_t k,
+              const ModInt<P>* a, size_t lda, const ModInt<P>* b, size_t ldb,
+              ModInt<P>* c, size_t ldc) {
+  const uint64_t kDelay = ModInt<P>::kDelayedProducts;
+  uint64_t acc[kGemmModTile];
+  for (size_t i = row_begin; i < row_end; ++i) {
+    for (size_t j0 = 0; j0 < n; j0 += kGemmModTile) {
+      size_t width = std::min(kGemmModTile, n - j0);
+      std::fill(acc, acc + width, 0);
+      uint64_t pending = 0;
+      for (size_t p = 0; p < k; ++p) {
+        if (pending == kDelay) {
+          for (size_t j = 0; j < width; ++j) {
+            acc[j] = ModInt<P>::Reduce(acc[j]);
+          }
+          // A reduced value is below P, which costs at most one product slot.
+          pending = 1;
+        }
+        uint64_t elem = a[i * lda + p].Value();
+        const ModInt<P>* b_row = b + p * ldb + j0;
+        for (size_t j = 0; j < width; ++j) {
+          acc[j] += elem * b_row[j].Value();
+        }
+        ++pending;
+      }
+      ModInt<P>* c_row = c + i * ldc + j0;
+      for (size_t j = 0; j < width; ++j) {
+        ModInt<P> sum = static_cast<int64_t>(ModInt<P>::Reduce(acc[j]));
+        if constexpr (Subtract) {
+          c_row[j] -= sum;
+        } else {
+          c_row[j] += sum;
+        }
+      }
+    }
+  }
+}
+
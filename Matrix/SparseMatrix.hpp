@@ -0,0 +1,271 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "../Parallel/ParallelFor.hpp"
+#include "Matrix.hpp"
+
+enum class SparseFormat { kCsr, kCsc };
+
+// Compressed sparse matrix. In CSR the outer dimension is the rows: the
+// non-zeros of row r are values_[offsets_[r] .. offsets_[r + 1]) with their
+// columns in indices_. CSC is the same with rows and columns swapped.
+const size_t kSpmvParallelNonZeros = size_t(1) << 16;
+
+template <typename T = int64_t>
+class SparseMatrix {
+ public:
+  SparseMatrix() = default;
+  SparseMatrix(size_t rows, size_t cols,
+               SparseFormat format = SparseFormat::kCsr);
+  template <size_t N, size_t M>
+  explicit SparseMatrix(const Matrix<N, M, T>& matrix,
+                        SparseFormat format = SparseFormat::kCsr);
+
+  size_t Rows() const;
+  size_t Cols() const;
+  size_t NonZeros() const;
+  SparseFormat Format() const;
+
+  SparseMatrix<T> ToCsr() const;
+  SparseMatrix<T> ToCsc() const;
+  template <size_t N, size_t M>
+  Matrix<N, M, T> ToDense() const;
+
+  std::vector<T> operator*(const std::vector<T>& vec) const;
+  SparseMatrix<T> operator*(const SparseMatrix<T>& matrix2) const;
+  template <size_t N, size_t M, size_t R>
+  Matrix<N, R, T> MultiplyDense(const Matrix<M, R, T>& matrix2) const;
+
+ private:
+  size_t Outer() const;
+  SparseMatrix<T> Converted(SparseFormat format) const;
+  void SpmvRows(size_t begin, size_t end, const T* vec, T* res) const;
+
+  size_t rows_ = 0;
+  size_t cols_ = 0;
+  SparseFormat format_ = SparseFormat::kCsr;
+  std::vector<size_t> offsets_ = std::vector<size_t>(1, 0);
+  std::vector<size_t> indices_;
+  std::vector<T> values_;
+};
+
+template <typename T>
+SparseMatrix<T>::SparseMatrix(size_t rows, size_t cols, SparseFormat format)
+    : rows_(rows), cols_(cols), format_(format) {
+  offsets_.assign(Outer() + 1, 0);
+}
+
+template <typename T>
+template <size_t N, size_t M>
+SparseMatrix<T>::SparseMatrix(const Matrix<N, M, T>& matrix,
+                              SparseFormat format)
+    : SparseMatrix(N, M, format) {
+  size_t outer = Outer();
+  size_t inner = format_ == SparseFormat::kCsr ? M : N;
+  for (size_t i = 0; i < outer; ++i) {
+    for (size_t j = 0; j < inner; ++j) {
+      T value = format_ == SparseFormat::kCsr ? matrix(i, j) : matrix(j, i);
+      if (value != T()) {
+        indices_.push_back(j);
+        values_.push_back(value);
+      }
+    }
+    offsets_[i + 1] = values_.size();
+  }
+}
+
+template <typename T>
+size_t SparseMatrix<T>::Rows() const {
+  return rows_;
+}
+
+template <typename T>
+size_t SparseMatrix<T>::Cols() const {
+  return cols_;
+}
+
+template <typename T>
+size_t SparseMatrix<T>::NonZeros() const {
+  return values_.size();
+}
+
+template <typename T>
+SparseFormat SparseMatrix<T>::Format() const {
+  return format_;
+}
+
+template <typename T>
+size_t SparseMatrix<T>::Outer() const {
+  return format_ == SparseFormat::kCsr ? rows_ : cols_;
+}
+
+template <typename T>
+SparseMatrix<T> SparseMatrix<T>::ToCsr() const {
+  return Converted(SparseFormat::kCsr);
+}
+
+template <typename T>
+SparseMatrix<T> SparseMatrix<T>::ToCsc() const {
+  return Converted(SparseFormat::kCsc);
+}
+
+// Switching between CSR and CSC is a transpose of the index structure:
+// count entries per inner index, prefix-sum the counts, then scatter.
+template <typename T>
+SparseMatrix<T> SparseMatrix<T>::Converted(SparseFormat format) const {
+  if (format == format_) {
+    return *this;
+  }
+  SparseMatrix<T> res(rows_, cols_, format);
+  size_t outer = Outer();
+  for (size_t index : indices_) {
+    ++res.offsets_[index + 1];
+  }
+  for (size_t i = 1; i < res.offsets_.size(); ++i) {
+    res.offsets_[i] += res.offsets_[i - 1];
+  }
+  res.indices_.resize(values_.size());
+  res.values_.resize(values_.size());
+  std::vector<size_t> next(res.offsets_.begin(), res.offsets_.end() - 1);
+  for (size_t i = 0; i < outer; ++i) {
+    for (size_t p = offsets_[i]; p < offsets_[i + 1]; ++p) {
+      size_t dst = next[indices_[p]]++;
+      res.indices_[dst] = i;
+      res.values_[dst] = values_[p];
+    }
+  }
+  return res;
+}
+
+template <typename T>
+template <size_t N, size_t M>
+Matrix<N, M, T> SparseMatrix<T>::ToDense() const {
+  if (N != rows_ || M != cols_) {
+    throw std::invalid_argument("Matrix shapes differ");
+  }
+  Matrix<N, M, T> res;
+  for (size_t i = 0; i < Outer(); ++i) {
+    for (size_t p = offsets_[i]; p < offsets_[i + 1]; ++p) {
+      if (format_ == SparseFormat::kCsr) {
+        res(i, indices_[p]) = values_[p];
+      } else {
+        res(indices_[p], i) = values_[p];
+      }
+    }
+  }
+  return res;
+}
+
+template <typename T>
+void SparseMatrix<T>::SpmvRows(size_t begin, size_t end, const T* vec,
+                               T* res) const {
+  for (size_t i = begin; i < end; ++i) {
+    T sum = T();
+    for (size_t p = offsets_[i]; p < offsets_[i + 1]; ++p) {
+      sum += values_[p] * vec[indices_[p]];
+    }
+    res[i] = sum;
+  }
+}
+
+template <typename T>
+std::vector<T> SparseMatrix<T>::operator*(const std::vector<T>& vec) const {
+  if (vec.size() != cols_) {
+    throw std::invalid_argument("Vector size differs from column count");
+  }
+  std::vector<T> res(rows_, T());
+  if (format_ == SparseFormat::kCsc) {
+    for (size_t j = 0; j < cols_; ++j) {
+      for (size_t p = offsets_[j]; p < offsets_[j + 1]; ++p) {
+        res[indices_[p]] += values_[p] * vec[j];
+      }
+    }
+    return res;
+  }
+  if (values_.size() < kSpmvParallelNonZeros) {
+    SpmvRows(0, rows_, vec.data(), res.data());
+    return res;
+  }
+  // Rows are handed out by non-zero count rather than by row count: a chunk
+  // of the non-zero range owns every row that starts inside it.
+  ParallelFor(0, values_.size(), kSpmvParallelNonZeros / 4,
+              [&](size_t begin, size_t end) {
+                auto first = offsets_.begin() + rows_;
+                size_t row_begin =
+                    std::lower_bound(offsets_.begin(), first, begin) -
+                    offsets_.begin();
+                size_t row_end =
+                    std::lower_bound(offsets_.begin(), first, end) -
+                    offsets_.begin();
+                SpmvRows(row_begin, row_end, vec.data(), res.data());
+              });
+  return res;
+}
+
+// Gustavson's row-by-row product with a dense accumulator and a marker array,
+// so each output row costs only the work of its contributing non-zeros.
+template <typename T>
+SparseMatrix<T> SparseMatrix<T>::operator*(
+    const SparseMatrix<T>& matrix2) const {
+  if (cols_ != matrix2.rows_) {
+    throw std::invalid_argument("Matrix shapes differ");
+  }
+  SparseMatrix<T> lhs = ToCsr();
+  SparseMatrix<T> rhs = matrix2.ToCsr();
+  SparseMatrix<T> res(rows_, matrix2.cols_);
+  std::vector<T> acc(res.cols_, T());
+  std::vector<size_t> marker(res.cols_, SIZE_MAX);
+  std::vector<size_t> row_columns;
+  for (size_t i = 0; i < rows_; ++i) {
+    row_columns.clear();
+    for (size_t p = lhs.offsets_[i]; p < lhs.offsets_[i + 1]; ++p) {
+      size_t k = lhs.indices_[p];
+      T elem = lhs.values_[p];
+      for (size_t q = rhs.offsets_[k]; q < rhs.offsets_[k + 1]; ++q) {
+        size_t j = rhs.indices_[q];
+        if (marker[j] != i) {
+          marker[j] = i;
+          acc[j] = T();
+          row_columns.push_back(j);
+        }
+        acc[j] += elem * rhs.values_[q];
+      }
+    }
+    std::sort(row_columns.begin(), row_columns.end());
+    for (size_t j : row_columns) {
+      if (acc[j] != T()) {
+        res.indices_.push_back(j);
+        res.values_.push_back(acc[j]);
+      }
+    }
+    res.offsets_[i + 1] = res.values_.size();
+  }
+  return format_ == SparseFormat::kCsr ? res : res.ToCsc();
+}
+
+template <typename T>
+template <size_t N, size_t M, size_t R>
+Matrix<N, R, T> SparseMatrix<T>::MultiplyDense(
+    const Matrix<M, R, T>& matrix2) const {
+  if (N != rows_ || M != cols_) {
+    throw std::invalid_argument("Matrix shapes differ");
+  }
+  Matrix<N, R, T> res;
+  const T* dense = matrix2.Data();
+  T* out = res.Data();
+  for (size_t i = 0; i < Outer(); ++i) {
+    for (size_t p = offsets_[i]; p < offsets_[i + 1]; ++p) {
+      size_t row = format_ == SparseFormat::kCsr ? i : indices_[p];
+      size_t k = format_ == SparseFormat::kCsr ? indices_[p] : i;
+      T elem = values_[p];
+      for (size_t j = 0; j < R; ++j) {
+        out[row * R + j] += elem * dense[k * R + j];
+      }
+    }
+  }
+  return res;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// Splits [begin, end) into contiguous chunks of at least min_chunk items and
+// runs func(chunk_begin, chunk_end) on each of them, one chunk per hardware
+// thread. Small ranges are processed on the calling thread.
+template <typename F>
+void ParallelFor(size_t begin, size_t end, size_t min_chunk, F&& func) {
+  size_t total = end > begin ? end - begin : 0;
+  size_t workers = std::max<size_t>(1, std::thread::hardware_concurrency());
+  workers = std::min(workers, total / std::max<size_t>(1, min_chunk));
+  if (workers <= 1) {
+    func(begin, end);
+    return;
+  }
+  size_t chunk = (total + workers - 1) / workers;
+  std::vector<std::thread> threads;
+  threads.reserve(workers - 1);
+  for (size_t lo = begin + chunk; lo < end; lo += chunk) {
+    threads.emplace_back(func, lo, std::min(end, lo + chunk));
+  }
+  func(begin, std::min(end, begin + chunk));
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
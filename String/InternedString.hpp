@@ -0,0 +1,246 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+#include <utility>
+
+#include "String.hpp"
+#include "StringHash.hpp"
+
+class InternPool;
+
+// Handle to an immutable string stored once per distinct value in an
+// InternPool. Handles are reference counted, compare by pointer and carry
+// the hash computed at interning time. The empty string is the null handle.
+// Handles must not outlive their pool.
+class InternedString {
+ public:
+  InternedString() = default;
+  InternedString(const InternedString& str2);
+  InternedString(InternedString&& str2) noexcept;
+  InternedString& operator=(const InternedString& str2);
+  InternedString& operator=(InternedString&& str2) noexcept;
+  ~InternedString();
+
+  const char* Data() const;
+  size_t Size() const;
+  bool Empty() const;
+  StringView View() const;
+  operator StringView() const;
+  uint64_t Hash() const;
+
+  // Interned strings are equal exactly when they come from the same entry.
+  friend bool operator==(const InternedString& str1,
+                         const InternedString& str2) {
+    return str1.entry_ == str2.entry_;
+  }
+  friend bool operator!=(const InternedString& str1,
+                         const InternedString& str2) {
+    return str1.entry_ != str2.entry_;
+  }
+
+ private:
+  friend class InternPool;
+
+  struct Entry {
+    std::atomic<size_t> refs;
+    InternPool* pool;
+    uint64_t hash;
+    size_t size;
+    // Followed by size characters and a '\0'.
+    char* Chars() { return reinterpret_cast<char*>(this + 1); }
+  };
+
+  // Adopts one reference to entry.
+  explicit InternedString(Entry* entry) : entry_(entry) {}
+
+  void Release();
+
+  Entry* entry_ = nullptr;
+};
+
+// Concurrent intern table. Strings are spread over kShards independently
+// locked hash maps by the top bits of their hash, so threads interning
+// different strings rarely contend. An entry is freed when its last handle
+// goes away. The count only reaches zero under the shard lock, and lookups
+// take their reference under the same lock, so a dying entry is never
+// handed out again.
+class InternPool {
+ public:
+  InternPool() = default;
+  InternPool(const InternPool&) = delete;
+  InternPool& operator=(const InternPool&) = delete;
+  ~InternPool();
+
+  // Process-wide pool.
+  static InternPool& Global();
+
+  InternedString Intern(StringView str);
+  // Number of distinct strings currently interned.
+  size_t Size() const;
+
+ private:
+  friend class InternedString;
+  using Entry = InternedString::Entry;
+
+  static const size_t kShardBits = 6;
+  static const size_t kShards = size_t(1) << kShardBits;
+
+  struct Key {
+    StringView view;
+    uint64_t hash;
+
+    bool operator==(const Key& key) const {
+      return hash == key.hash && view == key.view;
+    }
+  };
+
+  struct KeyHash {
+    size_t operator()(const Key& key) const { return key.hash; }
+  };
+
+  struct alignas(64) Shard {
+    mutable std::mutex mutex;
+    std::unordered_map<Key, Entry*, KeyHash> entries;
+  };
+
+  Shard& ShardOf(uint64_t hash) { return shards_[hash >> (64 - kShardBits)]; }
+  void Release(Entry* entry);
+
+  Shard shards_[kShards];
+};
+
+inline InternPool::~InternPool() {
+  for (Shard& shard : shards_) {
+    for (auto& [key, entry] : shard.entries) {
+      entry->~Entry();
+      ::operator delete(entry);
+    }
+  }
+}
+
+inline InternPool& InternPool::Global() {
+  static InternPool pool;
+  return pool;
+}
+
+inline InternedString InternPool::Intern(StringView str) {
+  if (str.Empty()) {
+    return InternedString();
+  }
+  uint64_t hash = HashBytes(str.Data(), str.Size());
+  Shard& shard = ShardOf(hash);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto found = shard.entries.find(Key{str, hash});
+  if (found != shard.entries.end()) {
+    found->second->refs.fetch_add(1, std::memory_order_relaxed);
+    return InternedString(found->second);
+  }
+  void* memory = ::operator new(sizeof(Entry) + str.Size() + 1);
+  Entry* entry = new (memory) Entry{{1}, this, hash, str.Size()};
+  std::memcpy(entry->Chars(), str.Data(), str.Size());
+  entry->Chars()[str.Size()] = '\0';
+  shard.entries.emplace(Key{StringView(entry->Chars(), str.Size()), hash},
+                        entry);
+  return InternedString(entry);
+}
+
+inline size_t InternPool::Size() const {
+  size_t size = 0;
+  for (const Shard& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    size += shard.entries.size();
+  }
+  return size;
+}
+
+inline void InternPool::Release(Entry* entry) {
+  // Dropping a reference that is not the last needs no lock.
+  size_t refs = entry->refs.load(std::memory_order_relaxed);
+  while (refs > 1) {
+    if (entry->refs.compare_exchange_weak(refs, refs - 1,
+                                          std::memory_order_release,
+                                          std::memory_order_relaxed)) {
+      return;
+    }
+  }
+  Shard& shard = ShardOf(entry->hash);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  if (entry->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+    return;
+  }
+  shard.entries.erase(
+      Key{StringView(entry->Chars(), entry->size), entry->hash});
+  entry->~Entry();
+  ::operator delete(entry);
+}
+
+inline InternedString::InternedString(const InternedString& str2)
+    : entry_(str2.entry_) {
+  if (entry_ != nullptr) {
+    entry_->refs.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+inline InternedString::InternedString(InternedString&& str2) noexcept
+    : entry_(std::exchange(str2.entry_, nullptr)) {}
+
+inline InternedString& InternedString::operator=(const InternedString& str2) {
+  InternedString copy(str2);
+  std::swap(entry_, copy.entry_);
+  return *this;
+}
+
+inline InternedString& InternedString::operator=(
+    InternedString&& str2) noexcept {
+  if (&str2 != this) {
+    Release();
+    entry_ = std::exchange(str2.entry_, nullptr);
+  }
+  return *this;
+}
+
+inline InternedString::~InternedString() { Release(); }
+
+inline void InternedString::Release() {
+  if (entry_ != nullptr) {
+    entry_->pool->Release(entry_);
+    entry_ = nullptr;
+  }
+}
+
+inline const char* InternedString::Data() const {
+  return entry_ == nullptr ? "" : entry_->Chars();
+}
+
+inline size_t InternedString::Size() const {
+  return entry_ == nullptr ? 0 : entry_->size;
+}
+
+inline bool InternedString::Empty() const { return entry_ == nullptr; }
+
+inline StringView InternedString::View() const {
+  return StringView(Data(), Size());
+}
+
+inline InternedString::operator StringView() const { return View(); }
+
+inline uint64_t InternedString::Hash() const {
+  return entry_ == nullptr ? HashBytes("", 0) : entry_->hash;
+}
+
+inline std::ostream& operator<<(std::ostream& ostream,
+                                const InternedString& str) {
+  return ostream << str.View();
+}
+
+template <>
+struct std::hash<InternedString> {
+  size_t operator()(const InternedString& str) const { return str.Hash(); }
+};
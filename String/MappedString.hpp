@@ -0,0 +1,176 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "StringView.hpp"
+
+// How a mapping is going to be read, passed on to madvise.
+enum class MappedAccess {
+  kNormal,
+  // Read ahead aggressively and drop pages soon after they were read, so a
+  // scan of a file larger than RAM streams through the page cache.
+  kSequential,
+  kRandom,
+  // Start reading the range in now.
+  kWillNeed,
+};
+
+// Read-only mapping of a whole file, queried like an immutable String. The
+// bytes stay in the page cache and are never copied to the heap; views,
+// Find results and Split tokens point into the mapping and are valid for
+// the lifetime of the object.
+class MappedString {
+ public:
+  static const size_t kNpos = kStringNpos;
+
+  explicit MappedString(const std::string& path,
+                        MappedAccess access = MappedAccess::kSequential);
+  MappedString(const MappedString&) = delete;
+  MappedString& operator=(const MappedString&) = delete;
+  ~MappedString();
+
+  size_t Size() const;
+  bool Empty() const;
+  const char* Data() const;
+  const char& operator[](size_t index) const;
+  StringView View() const;
+  operator StringView() const;
+
+  size_t Find(StringView needle, size_t pos = 0) const;
+  size_t Find(char character, size_t pos = 0) const;
+  std::vector<size_t> FindAll(StringView needle) const;
+  size_t FindFirstOf(StringView bytes, size_t pos = 0) const;
+  SplitView Split(StringView delim = " ") const;
+  SplitAnyView SplitAny(StringView delims) const;
+
+  // Applies access to the pages covering [pos, pos + count), by default the
+  // whole file. A scanner can mark the window ahead of it kWillNeed.
+  void Advise(MappedAccess access, size_t pos = 0,
+              size_t count = kNpos) const;
+
+ private:
+  void* mapping_ = MAP_FAILED;
+  size_t length_ = 0;
+};
+
+inline MappedString::MappedString(const std::string& path,
+                                  MappedAccess access) {
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    throw std::system_error(errno, std::generic_category(), path);
+  }
+  struct stat info {};
+  if (fstat(fd, &info) != 0) {
+    int error = errno;
+    close(fd);
+    throw std::system_error(error, std::generic_category(), path);
+  }
+  if (!S_ISREG(info.st_mode)) {
+    close(fd);
+    throw std::runtime_error("Not a regular file: " + path);
+  }
+  length_ = static_cast<size_t>(info.st_size);
+  // mmap rejects empty ranges; an empty file stays unmapped.
+  if (length_ == 0) {
+    close(fd);
+    return;
+  }
+  mapping_ = mmap(nullptr, length_, PROT_READ, MAP_SHARED, fd, 0);
+  int error = errno;
+  close(fd);
+  if (mapping_ == MAP_FAILED) {
+    throw std::system_error(error, std::generic_category(), path);
+  }
+  Advise(access);
+}
+
+inline MappedString::~MappedString() {
+  if (mapping_ != MAP_FAILED) {
+    munmap(mapping_, length_);
+  }
+}
+
+inline size_t MappedString::Size() const { return length_; }
+
+inline bool MappedString::Empty() const { return length_ == 0; }
+
+inline const char* MappedString::Data() const {
+  return mapping_ == MAP_FAILED ? "" : static_cast<const char*>(mapping_);
+}
+
+inline const char& MappedString::operator[](size_t index) const {
+  return Data()[index];
+}
+
+inline StringView MappedString::View() const {
+  return StringView(Data(), length_);
+}
+
+inline MappedString::operator StringView() const { return View(); }
+
+inline size_t MappedString::Find(StringView needle, size_t pos) const {
+  return View().Find(needle, pos);
+}
+
+inline size_t MappedString::Find(char character, size_t pos) const {
+  return View().Find(character, pos);
+}
+
+inline std::vector<size_t> MappedString::FindAll(StringView needle) const {
+  return View().FindAll(needle);
+}
+
+inline size_t MappedString::FindFirstOf(StringView bytes, size_t pos) const {
+  return View().FindFirstOf(bytes, pos);
+}
+
+inline SplitView MappedString::Split(StringView delim) const {
+  return View().Split(delim);
+}
+
+inline SplitAnyView MappedString::SplitAny(StringView delims) const {
+  return View().SplitAny(delims);
+}
+
+inline void MappedString::Advise(MappedAccess access, size_t pos,
+                                 size_t count) const {
+  if (pos > length_) {
+    throw std::out_of_range("Out of range");
+  }
+  count = std::min(count, length_ - pos);
+  if (count == 0) {
+    return;
+  }
+  int advice = MADV_NORMAL;
+  switch (access) {
+    case MappedAccess::kNormal:
+      advice = MADV_NORMAL;
+      break;
+    case MappedAccess::kSequential:
+      advice = MADV_SEQUENTIAL;
+      break;
+    case MappedAccess::kRandom:
+      advice = MADV_RANDOM;
+      break;
+    case MappedAccess::kWillNeed:
+      advice = MADV_WILLNEED;
+      break;
+  }
+  // madvise wants a page-aligned start; the mapping itself is page-aligned.
+  size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  size_t begin = pos / page * page;
+  // Only a hint, so failures are ignored.
+  madvise(static_cast<char*>(mapping_) + begin, pos + count - begin, advice);
+}
@@ -0,0 +1,264 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "String.hpp"
+#include "StringView.hpp"
+
+// Aho-Corasick automaton over a fixed set of patterns, compiled to a DFA so
+// a scan costs one table lookup per input byte however many patterns there
+// are. Bytes that play the same role in every pattern share a column of the
+// table, so its width is the number of distinct pattern bytes plus one, not
+// 256. Every occurrence of every pattern is reported, overlapping ones
+// included, in order of where they end; occurrences ending at the same byte
+// come longest first.
+class MultiMatcher {
+ public:
+  struct Match {
+    // Index of the pattern in the list the matcher was built from.
+    size_t pattern;
+    // Offset of the first character of the occurrence.
+    size_t pos;
+
+    bool operator==(const Match& match) const = default;
+  };
+
+  class Stream;
+
+  // Patterns must not be empty. Duplicates are reported once per copy.
+  explicit MultiMatcher(const std::vector<String>& patterns);
+  explicit MultiMatcher(const std::vector<StringView>& patterns);
+
+  size_t PatternCount() const;
+  size_t StateCount() const;
+
+  // Calls on_match(Match) for every occurrence in text.
+  template <typename F>
+  void Scan(StringView text, F on_match) const;
+  std::vector<Match> FindAll(StringView text) const;
+  bool Contains(StringView text) const;
+
+ private:
+  void Build(const std::vector<StringView>& patterns);
+  // Advances over text from entry and returns the entry reached. pos is the
+  // offset of text[0] in the whole input.
+  template <typename F>
+  uint32_t Run(uint32_t entry, StringView text, size_t pos,
+               F& on_match) const;
+
+  uint16_t class_[256] = {};
+  uint32_t classes_ = 0;
+  // Table entries are the row offset of the next state, state * classes_.
+  // States in which some pattern ends are numbered last, so an entry of at
+  // least match_begin_ means a match and the hot loop needs no flag test.
+  std::vector<uint32_t> table_;
+  uint32_t match_begin_ = 0;
+  // Patterns ending in state s are outputs_[out_begin_[s], out_begin_[s+1]).
+  std::vector<uint32_t> out_begin_;
+  std::vector<uint32_t> outputs_;
+  std::vector<size_t> sizes_;
+};
+
+// Incremental scan of input that arrives in chunks. The automaton state is
+// carried over, so occurrences spanning chunk boundaries are found, and
+// positions count from the start of the whole input. The matcher must
+// outlive the stream.
+class MultiMatcher::Stream {
+ public:
+  explicit Stream(const MultiMatcher& matcher);
+
+  template <typename F>
+  void Feed(StringView chunk, F on_match);
+  std::vector<Match> Feed(StringView chunk);
+  // Bytes fed so far.
+  size_t Offset() const;
+  // Forgets everything fed so far.
+  void Reset();
+
+ private:
+  const MultiMatcher* matcher_;
+  uint32_t entry_ = 0;
+  size_t offset_ = 0;
+};
+
+inline MultiMatcher::MultiMatcher(const std::vector<String>& patterns) {
+  std::vector<StringView> views(patterns.begin(), patterns.end());
+  Build(views);
+}
+
+inline MultiMatcher::MultiMatcher(const std::vector<StringView>& patterns) {
+  Build(patterns);
+}
+
+inline void MultiMatcher::Build(const std::vector<StringView>& patterns) {
+  for (StringView pattern : patterns) {
+    if (pattern.Empty()) {
+      throw std::invalid_argument("Empty pattern");
+    }
+    sizes_.push_back(pattern.Size());
+    for (char character : pattern) {
+      class_[static_cast<uint8_t>(character)] = 1;
+    }
+  }
+  // Class 0 is every byte that occurs in no pattern.
+  classes_ = 1;
+  for (uint16_t& cls : class_) {
+    cls = cls != 0 ? static_cast<uint16_t>(classes_++) : 0;
+  }
+
+  // Trie. 0 is the root, which is nobody's child, so a 0 in a row means no
+  // edge yet.
+  std::vector<uint32_t> next(classes_, 0);
+  std::vector<std::vector<uint32_t>> own(1);
+  for (size_t i = 0; i < patterns.size(); ++i) {
+    size_t state = 0;
+    for (char character : patterns[i]) {
+      size_t cell = state * classes_ + class_[static_cast<uint8_t>(character)];
+      if (next[cell] == 0) {
+        next[cell] = static_cast<uint32_t>(own.size());
+        own.emplace_back();
+        next.resize(own.size() * classes_, 0);
+      }
+      state = next[cell];
+    }
+    own[state].push_back(static_cast<uint32_t>(i));
+  }
+  size_t states = own.size();
+  if (states * classes_ > UINT32_MAX) {
+    throw std::length_error("Too many patterns");
+  }
+
+  // Breadth-first, so the failure state of every state, being shallower, is
+  // complete before the state itself. Missing edges are filled in from the
+  // failure state, which turns the trie into a DFA.
+  std::vector<uint32_t> fail(states, 0);
+  std::vector<uint32_t> order;
+  order.reserve(states);
+  for (uint32_t cls = 0; cls < classes_; ++cls) {
+    if (next[cls] != 0) {
+      order.push_back(next[cls]);
+    }
+  }
+  for (size_t i = 0; i < order.size(); ++i) {
+    uint32_t state = order[i];
+    for (uint32_t cls = 0; cls < classes_; ++cls) {
+      uint32_t& child = next[state * classes_ + cls];
+      uint32_t fallback = next[fail[state] * classes_ + cls];
+      if (child != 0) {
+        fail[child] = fallback;
+        order.push_back(child);
+      } else {
+        child = fallback;
+      }
+    }
+  }
+
+  // A state matches its own patterns and everything its failure state
+  // matches, which is complete by now in breadth-first order.
+  std::vector<std::vector<uint32_t>> out(states);
+  for (uint32_t state : order) {
+    out[state] = own[state];
+    const std::vector<uint32_t>& inherited = out[fail[state]];
+    out[state].insert(out[state].end(), inherited.begin(), inherited.end());
+  }
+
+  // Renumber breadth-first, which keeps the shallow states, where a scan
+  // spends most of its time, in adjacent rows. States without output come
+  // first, starting with the root.
+  order.insert(order.begin(), 0);
+  std::vector<uint32_t> number(states);
+  std::vector<uint32_t> by_number;
+  by_number.reserve(states);
+  for (int matching = 0; matching < 2; ++matching) {
+    if (matching == 1) {
+      match_begin_ = static_cast<uint32_t>(by_number.size() * classes_);
+    }
+    for (uint32_t state : order) {
+      if (out[state].empty() != (matching == 1)) {
+        number[state] = static_cast<uint32_t>(by_number.size());
+        by_number.push_back(state);
+      }
+    }
+  }
+  out_begin_.reserve(states + 1);
+  table_.reserve(next.size());
+  for (uint32_t state : by_number) {
+    out_begin_.push_back(static_cast<uint32_t>(outputs_.size()));
+    outputs_.insert(outputs_.end(), out[state].begin(), out[state].end());
+    for (uint32_t cls = 0; cls < classes_; ++cls) {
+      table_.push_back(number[next[state * classes_ + cls]] * classes_);
+    }
+  }
+  out_begin_.push_back(static_cast<uint32_t>(outputs_.size()));
+}
+
+inline size_t MultiMatcher::PatternCount() const { return sizes_.size(); }
+
+inline size_t MultiMatcher::StateCount() const {
+  return out_begin_.size() - 1;
+}
+
+template <typename F>
+uint32_t MultiMatcher::Run(uint32_t entry, StringView text, size_t pos,
+                           F& on_match) const {
+  const uint32_t* table = table_.data();
+  for (size_t i = 0; i < text.Size(); ++i) {
+    entry = table[entry + class_[static_cast<uint8_t>(text[i])]];
+    if (entry >= match_begin_) {
+      size_t state = entry / classes_;
+      size_t end = pos + i + 1;
+      for (uint32_t k = out_begin_[state]; k < out_begin_[state + 1]; ++k) {
+        on_match(Match{outputs_[k], end - sizes_[outputs_[k]]});
+      }
+    }
+  }
+  return entry;
+}
+
+template <typename F>
+void MultiMatcher::Scan(StringView text, F on_match) const {
+  Run(0, text, 0, on_match);
+}
+
+inline std::vector<MultiMatcher::Match> MultiMatcher::FindAll(
+    StringView text) const {
+  std::vector<Match> res;
+  Scan(text, [&](const Match& match) { res.push_back(match); });
+  return res;
+}
+
+inline bool MultiMatcher::Contains(StringView text) const {
+  uint32_t entry = 0;
+  for (size_t i = 0; i < text.Size(); ++i) {
+    entry = table_[entry + class_[static_cast<uint8_t>(text[i])]];
+    if (entry >= match_begin_) {
+      return true;
+    }
+  }
+  return false;
+}
+
+inline MultiMatcher::Stream::Stream(const MultiMatcher& matcher)
+    : matcher_(&matcher) {}
+
+template <typename F>
+void MultiMatcher::Stream::Feed(StringView chunk, F on_match) {
+  entry_ = matcher_->Run(entry_, chunk, offset_, on_match);
+  offset_ += chunk.Size();
+}
+
+inline std::vector<MultiMatcher::Match> MultiMatcher::Stream::Feed(
+    StringView chunk) {
+  std::vector<Match> res;
+  Feed(chunk, [&](const Match& match) { res.push_back(match); });
+  return res;
+}
+
+inline size_t MultiMatcher::Stream::Offset() const { return offset_; }
+
+inline void MultiMatcher::Stream::Reset() {
+  entry_ = 0;
+  offset_ = 0;
+}
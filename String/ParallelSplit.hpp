@@ -0,0 +1,120 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "../Parallel/ParallelFor.hpp"
+#include "StringSearch.hpp"
+#include "StringView.hpp"
+
+// Inputs are cut into at most one chunk per hardware thread, and chunks are
+// never smaller than this.
+const size_t kParallelSplitMinChunk = size_t(1) << 20;
+
+// Splits text on delim like StringView::Split, on all hardware threads, and
+// returns the tokens in order as views into text. The result is the same
+// for any thread count.
+//
+// Every thread collects the delimiter matches that start in its chunk,
+// scanning from the chunk start as if it were the start of the input. A
+// match may end past its chunk; the next chunk then has to drop its matches
+// that overlap it. For a self-overlapping delimiter such as "aa" that can
+// shift which later matches a left-to-right scan picks, so that chunk is
+// rescanned from the end of the spilled match until the two scans agree on
+// a match, after which they agree on all of them. The stitching touches
+// only the matches near chunk starts; the tokens are again cut in parallel.
+template <typename Delimiter>
+std::vector<StringView> ParallelSplitBy(StringView text,
+                                        const Delimiter& delim) {
+  size_t match = delim.MatchSize();
+  if (match == 0) {
+    return {text};
+  }
+  size_t size = text.Size();
+  size_t chunks = std::max<size_t>(1, std::thread::hardware_concurrency());
+  chunks = std::max<size_t>(
+      1, std::min(chunks, size / kParallelSplitMinChunk));
+  size_t chunk = (size + chunks - 1) / chunks;
+  auto chunk_begin = [&](size_t i) { return std::min(size, i * chunk); };
+
+  // Starts of the matches of each chunk, chained left to right from the
+  // chunk start. A search stops at the last byte a match starting in the
+  // chunk can use.
+  std::vector<std::vector<size_t>> starts(chunks);
+  ParallelFor(0, chunks, 1, [&](size_t lo, size_t hi) {
+    for (size_t i = lo; i < hi; ++i) {
+      size_t end = chunk_begin(i + 1);
+      size_t limit = std::min(size, end + match - 1);
+      for (size_t pos = delim.Find(text.Data(), limit, chunk_begin(i));
+           pos != StringView::kNpos && pos < end;
+           pos = delim.Find(text.Data(), limit, pos + match)) {
+        starts[i].push_back(pos);
+      }
+    }
+  });
+
+  // Fix up the chunk starts in order, leaving in starts[i] exactly the
+  // matches a sequential scan takes. opened[i] is where the token that is
+  // open when chunk i starts began, counts[i] its index.
+  std::vector<size_t> opened(chunks, 0);
+  std::vector<size_t> counts(chunks + 1, 0);
+  size_t resume = 0;
+  for (size_t i = 0; i < chunks; ++i) {
+    std::vector<size_t>& list = starts[i];
+    size_t end = chunk_begin(i + 1);
+    size_t limit = std::min(size, end + match - 1);
+    opened[i] = resume;
+    size_t k = 0;
+    while (k < list.size() && list[k] < resume) {
+      ++k;
+    }
+    if (k != 0) {
+      // The chunk chained from a position inside the spilled match. Follow
+      // the sequential chain until it lands on an entry of the list.
+      std::vector<size_t> fixed;
+      size_t pos = delim.Find(text.Data(), limit, resume);
+      while (pos != StringView::kNpos && pos < end &&
+             (k == list.size() || pos != list[k])) {
+        fixed.push_back(pos);
+        while (k < list.size() && list[k] < pos + match) {
+          ++k;
+        }
+        pos = delim.Find(text.Data(), limit, pos + match);
+      }
+      fixed.insert(fixed.end(), list.begin() + static_cast<ptrdiff_t>(k),
+                   list.end());
+      list = std::move(fixed);
+    }
+    counts[i + 1] = counts[i] + list.size();
+    if (!list.empty()) {
+      resume = list.back() + match;
+    }
+  }
+
+  // Token j ends at match j, and the last one runs to the end of text.
+  std::vector<StringView> tokens(counts[chunks] + 1);
+  ParallelFor(0, chunks, 1, [&](size_t lo, size_t hi) {
+    for (size_t i = lo; i < hi; ++i) {
+      size_t begin = opened[i];
+      size_t index = counts[i];
+      for (size_t pos : starts[i]) {
+        tokens[index++] = StringView(text.Data() + begin, pos - begin);
+        begin = pos + match;
+      }
+    }
+  });
+  tokens.back() = text.Substr(resume);
+  return tokens;
+}
+
+inline std::vector<StringView> ParallelSplit(StringView text,
+                                             StringView delim = " ") {
+  return ParallelSplitBy(text, Searcher(delim.Data(), delim.Size()));
+}
+
+// Splits on every byte that occurs in delims.
+inline std::vector<StringView> ParallelSplitAny(StringView text,
+                                                StringView delims) {
+  return ParallelSplitBy(text, ByteSet(delims.Data(), delims.Size()));
+}
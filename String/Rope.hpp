@@ -0,0 +1,322 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "String.hpp"
+
+// Immutable string stored as a height-balanced binary tree whose leaves are
+// views into shared, immutable String chunks. Concatenation, Substr and
+// indexing are O(log n) and never copy the chunks, and a Rope is cheap to
+// copy because copies share the whole tree. ToString() flattens on demand,
+// and Chunks() walks the leaves in order for writev-style output.
+class Rope {
+  struct Node;
+  using NodePtr = std::shared_ptr<const Node>;
+
+ public:
+  class ChunkIterator;
+  class ChunkRange;
+
+  Rope() = default;
+  Rope(const char* str);
+  explicit Rope(StringView str);
+  explicit Rope(String str);
+
+  size_t Size() const;
+  bool Empty() const;
+  // Character at index, O(log n).
+  char operator[](size_t index) const;
+  char At(size_t index) const;
+  // Rope of at most count characters starting at pos, sharing the chunks.
+  Rope Substr(size_t pos, size_t count = StringView::kNpos) const;
+  size_t Height() const;
+
+  Rope& operator+=(const Rope& rope);
+  friend Rope operator+(const Rope& rope1, const Rope& rope2);
+
+  String ToString() const;
+  ChunkRange Chunks() const;
+
+ private:
+  // Adjacent leaves up to this size are merged by copying, so appending many
+  // small pieces builds a few big leaves instead of a deep tree of tiny ones.
+  static const size_t kMergeLeaf = 512;
+
+  explicit Rope(NodePtr root) : root_(std::move(root)) {}
+
+  static int HeightOf(const NodePtr& node);
+  static size_t SizeOf(const NodePtr& node);
+  static NodePtr MakeLeaf(std::shared_ptr<const String> chunk, size_t offset,
+                          size_t size);
+  static NodePtr MakeConcat(NodePtr left, NodePtr right);
+  static NodePtr Join(const NodePtr& left, const NodePtr& right);
+  static NodePtr Slice(const NodePtr& node, size_t begin, size_t end);
+
+  NodePtr root_;
+};
+
+// A leaf when left and right are null; it then covers chunk[offset,
+// offset + size). Leaves have height 0.
+struct Rope::Node {
+  NodePtr left;
+  NodePtr right;
+  std::shared_ptr<const String> chunk;
+  size_t offset = 0;
+  size_t size = 0;
+  int height = 0;
+
+  bool IsLeaf() const { return left == nullptr; }
+  StringView Leaf() const {
+    return StringView(chunk->Data() + offset, size);
+  }
+};
+
+// Forward iterator over the leaves of a rope, left to right, as views. It
+// keeps the right subtrees still to visit on the way down to the current
+// leaf, so a full walk is O(n) in leaves. Subtrees may be shared, even
+// between the two sides of one node, so the walk never looks at parents.
+class Rope::ChunkIterator {
+ public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = StringView;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const StringView*;
+  using reference = StringView;
+
+  ChunkIterator() = default;
+
+  StringView operator*() const { return leaf_->Leaf(); }
+  ChunkIterator& operator++();
+  ChunkIterator operator++(int);
+
+  bool operator==(const ChunkIterator& iter) const {
+    return leaf_ == iter.leaf_ && pending_ == iter.pending_;
+  }
+  bool operator!=(const ChunkIterator& iter) const { return !(*this == iter); }
+
+ private:
+  friend class Rope;
+
+  explicit ChunkIterator(const Node* root);
+  void DescendLeft(const Node* node);
+
+  const Node* leaf_ = nullptr;
+  std::vector<const Node*> pending_;
+};
+
+class Rope::ChunkRange {
+ public:
+  ChunkIterator begin() const { return ChunkIterator(root_.get()); }
+  ChunkIterator end() const { return ChunkIterator(); }
+
+ private:
+  friend class Rope;
+
+  explicit ChunkRange(NodePtr root) : root_(std::move(root)) {}
+
+  NodePtr root_;
+};
+
+inline Rope::Rope(const char* str) : Rope(StringView(str)) {}
+
+inline Rope::Rope(StringView str) : Rope(String(str)) {}
+
+inline Rope::Rope(String str) {
+  if (!str.Empty()) {
+    size_t size = str.Size();
+    root_ = MakeLeaf(std::make_shared<const String>(std::move(str)), 0, size);
+  }
+}
+
+inline int Rope::HeightOf(const NodePtr& node) {
+  return node == nullptr ? 0 : node->height;
+}
+
+inline size_t Rope::SizeOf(const NodePtr& node) {
+  return node == nullptr ? 0 : node->size;
+}
+
+inline Rope::NodePtr Rope::MakeLeaf(std::shared_ptr<const String> chunk,
+                                    size_t offset, size_t size) {
+  auto node = std::make_shared<Node>();
+  node->chunk = std::move(chunk);
+  node->offset = offset;
+  node->size = size;
+  return node;
+}
+
+inline Rope::NodePtr Rope::MakeConcat(NodePtr left, NodePtr right) {
+  auto node = std::make_shared<Node>();
+  node->size = left->size + right->size;
+  node->height = std::max(left->height, right->height) + 1;
+  node->left = std::move(left);
+  node->right = std::move(right);
+  return node;
+}
+
+// AVL join: walks down the spine of the taller tree until the heights are
+// within one, links there and rotates on the way back up. The cost is
+// O(|height(left) - height(right)| + 1), and the result is again balanced.
+inline Rope::NodePtr Rope::Join(const NodePtr& left, const NodePtr& right) {
+  if (left == nullptr) {
+    return right;
+  }
+  if (right == nullptr) {
+    return left;
+  }
+  if (left->IsLeaf() && right->IsLeaf() &&
+      left->size + right->size <= kMergeLeaf) {
+    String merged;
+    merged.Reserve(left->size + right->size);
+    merged.Append(left->Leaf());
+    merged.Append(right->Leaf());
+    size_t size = merged.Size();
+    return MakeLeaf(std::make_shared<const String>(std::move(merged)), 0,
+                    size);
+  }
+  if (left->height > right->height + 1) {
+    NodePtr joined = Join(left->right, right);
+    if (joined->height <= left->left->height + 1) {
+      return MakeConcat(left->left, std::move(joined));
+    }
+    if (joined->left->height <= joined->right->height) {
+      return MakeConcat(MakeConcat(left->left, joined->left), joined->right);
+    }
+    return MakeConcat(MakeConcat(left->left, joined->left->left),
+                      MakeConcat(joined->left->right, joined->right));
+  }
+  if (right->height > left->height + 1) {
+    NodePtr joined = Join(left, right->left);
+    if (joined->height <= right->right->height + 1) {
+      return MakeConcat(std::move(joined), right->right);
+    }
+    if (joined->right->height <= joined->left->height) {
+      return MakeConcat(joined->left, MakeConcat(joined->right, right->right));
+    }
+    return MakeConcat(MakeConcat(joined->left, joined->right->left),
+                      MakeConcat(joined->right->right, right->right));
+  }
+  return MakeConcat(left, right);
+}
+
+// Characters [begin, end) of node, reusing every subtree that lies inside
+// the range.
+inline Rope::NodePtr Rope::Slice(const NodePtr& node, size_t begin,
+                                 size_t end) {
+  if (begin == 0 && end == node->size) {
+    return node;
+  }
+  if (begin == end) {
+    return nullptr;
+  }
+  if (node->IsLeaf()) {
+    return MakeLeaf(node->chunk, node->offset + begin, end - begin);
+  }
+  size_t left_size = node->left->size;
+  if (end <= left_size) {
+    return Slice(node->left, begin, end);
+  }
+  if (begin >= left_size) {
+    return Slice(node->right, begin - left_size, end - left_size);
+  }
+  return Join(Slice(node->left, begin, left_size),
+              Slice(node->right, 0, end - left_size));
+}
+
+inline size_t Rope::Size() const { return SizeOf(root_); }
+
+inline bool Rope::Empty() const { return root_ == nullptr; }
+
+inline size_t Rope::Height() const { return HeightOf(root_); }
+
+inline char Rope::operator[](size_t index) const {
+  const Node* node = root_.get();
+  while (!node->IsLeaf()) {
+    if (index < node->left->size) {
+      node = node->left.get();
+    } else {
+      index -= node->left->size;
+      node = node->right.get();
+    }
+  }
+  return node->chunk->Data()[node->offset + index];
+}
+
+inline char Rope::At(size_t index) const {
+  if (index >= Size()) {
+    throw std::out_of_range("Out of range");
+  }
+  return (*this)[index];
+}
+
+inline Rope Rope::Substr(size_t pos, size_t count) const {
+  if (pos > Size()) {
+    throw std::out_of_range("Out of range");
+  }
+  size_t end = pos + std::min(count, Size() - pos);
+  return root_ == nullptr ? Rope() : Rope(Slice(root_, pos, end));
+}
+
+inline Rope& Rope::operator+=(const Rope& rope) {
+  root_ = Join(root_, rope.root_);
+  return *this;
+}
+
+inline Rope operator+(const Rope& rope1, const Rope& rope2) {
+  return Rope(Rope::Join(rope1.root_, rope2.root_));
+}
+
+inline String Rope::ToString() const {
+  String res;
+  res.Reserve(Size());
+  for (StringView chunk : Chunks()) {
+    res.Append(chunk);
+  }
+  return res;
+}
+
+inline Rope::ChunkRange Rope::Chunks() const { return ChunkRange(root_); }
+
+inline std::ostream& operator<<(std::ostream& ostream, const Rope& rope) {
+  for (StringView chunk : rope.Chunks()) {
+    ostream << chunk;
+  }
+  return ostream;
+}
+
+inline Rope::ChunkIterator::ChunkIterator(const Node* root) {
+  if (root != nullptr) {
+    DescendLeft(root);
+  }
+}
+
+inline void Rope::ChunkIterator::DescendLeft(const Node* node) {
+  while (!node->IsLeaf()) {
+    pending_.push_back(node->right.get());
+    node = node->left.get();
+  }
+  leaf_ = node;
+}
+
+inline Rope::ChunkIterator& Rope::ChunkIterator::operator++() {
+  if (pending_.empty()) {
+    leaf_ = nullptr;
+    return *this;
+  }
+  const Node* next = pending_.back();
+  pending_.pop_back();
+  DescendLeft(next);
+  return *this;
+}
+
+inline Rope::ChunkIterator Rope::ChunkIterator::operator++(int) {
+  ChunkIterator iter(*this);
+  ++*this;
+  return iter;
+}
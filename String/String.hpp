@@ -1,17 +1,43 @@
 #pragma once
+#include <algorithm>
+#include <bit>
+#include <compare>
 #include <cstdint>
 #include <cstring>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <memory_resource>
+#include <utility>
 #include <vector>
 
-class String {
+#include "StringHash.hpp"
+#include "StringView.hpp"
+
+template <typename Allocator = std::allocator<char>>
+class BasicString {
+  using alloc_traits = std::allocator_traits<Allocator>;
+
  public:
-  String();
-  String(size_t size, char character);
-  String(const String&);
-  String(const char* str);
-  String& operator=(const String& str2);
-  ~String();
+  using value_type = char;
+  using allocator_type = Allocator;
+
+  BasicString() = default;
+  explicit BasicString(const Allocator& alloc);
+  BasicString(size_t size, char character,
+              const Allocator& alloc = Allocator());
+  BasicString(const BasicString&);
+  BasicString(const BasicString& str2, const Allocator& alloc);
+  BasicString(BasicString&& str2) noexcept;
+  BasicString(const char* str, const Allocator& alloc = Allocator());
+  BasicString(const char* str, size_t size,
+              const Allocator& alloc = Allocator());
+  explicit BasicString(StringView str, const Allocator& alloc = Allocator());
+  BasicString& operator=(const BasicString& str2);
+  BasicString& operator=(BasicString&& str2) noexcept(kNothrowMoveAssign);
+  ~BasicString();
+
+  allocator_type get_allocator() const { return alloc_; }
 
   void Clear();
   void PushBack(char character);
@@ -20,7 +46,12 @@ class String {
   void Resize(size_t new_size, char character);
   void Reserve(size_t new_cap);
   void ShrinkToFit();
-  void Swap(String& other);
+  // Makes room for count characters and lets op(Data(), count) write them in
+  // place. op returns the new size, at most count; characters past the old
+  // size start out indeterminate, so nothing is zero-filled first.
+  template <typename Op>
+  void ResizeAndOverwrite(size_t count, Op op);
+  void Swap(BasicString& other);
   const char& operator[](int index) const;
   char& operator[](int index);
   const char& Front() const;
@@ -32,32 +63,636 @@ class String {
   size_t Capacity() const;
   char* Data();
   const char* Data() const;
+  StringView View() const;
+  operator StringView() const;
 
-  String& operator+=(const String& str2);
-  String& operator+=(char str);
-  String& operator*=(size_t n);
-  String operator*(const char* str, int n);
-  void NewSizeAndCap(const String& str1, const String& str2);
+  BasicString& operator+=(const BasicString& str2);
+  BasicString& operator+=(char str);
+  BasicString& Append(StringView str);
+  BasicString& operator*=(size_t n);
+  void NewSizeAndCap(const BasicString& str1, const BasicString& str2);
   char* ReturnStr() const;
   size_t ReturnSize() const;
 
-  std::vector<String> Split(const String& delim = " ");
-  String Join(const std::vector<String>& strings) const;
-  std::vector<String> Split2(std::vector<String>& res, const String& delim);
+  size_t Find(StringView needle, size_t pos = 0) const;
+  std::vector<size_t> FindAll(StringView needle) const;
+
+  std::vector<BasicString> Split(StringView delim = " ");
+  BasicString Join(const std::vector<BasicString>& strings) const;
+  std::vector<BasicString> Split2(std::vector<BasicString>& res,
+                                  const BasicString& delim);
+
+  // Lexicographic byte order, one memcmp per comparison; the other relational
+  // operators are rewritten from these two.
+  friend std::strong_ordering operator<=>(const BasicString& str1,
+                                          const BasicString& str2) {
+    return str1.View() <=> str2.View();
+  }
+
+  friend bool operator==(const BasicString& str1, const BasicString& str2) {
+    return str1.Size() == str2.Size() &&
+           std::memcmp(str1.Data(), str2.Data(), str1.Size()) == 0;
+  }
+
+  friend BasicString operator+(const BasicString& str1,
+                               const BasicString& str2) {
+    BasicString res(str1.alloc_);
+    res.Reserve(str1.Size() + str2.Size());
+    res += str1;
+    res += str2;
+    return res;
+  }
+
+  // The rvalue overloads reuse the buffer of a temporary operand, so chains
+  // like a + b + c append in place instead of copying at every step.
+  friend BasicString operator+(BasicString&& str1, const BasicString& str2) {
+    str1 += str2;
+    return std::move(str1);
+  }
+
+  friend BasicString operator+(const BasicString& str1, BasicString&& str2) {
+    str2.Prepend(str1.Data(), str1.Size());
+    return std::move(str2);
+  }
+
+  friend BasicString operator+(BasicString&& str1, BasicString&& str2) {
+    size_t size = str1.Size() + str2.Size();
+    if (size > str1.Capacity() && size <= str2.Capacity()) {
+      return static_cast<const BasicString&>(str1) + std::move(str2);
+    }
+    str1 += str2;
+    return std::move(str1);
+  }
 
  private:
-  char* str_;
-  size_t size_;
-  size_t capacity_;
+  // Small string optimization. Strings of up to kShortCapacity characters are
+  // stored inside the object: the bytes of str_, size_ and capacity_ hold the
+  // characters and the terminating '\0', and the last of those bytes holds
+  // the size. Long strings set kLongFlag in capacity_, whose top byte is that
+  // same last byte, so the flag tells the two modes apart.
+  static const size_t kRepBytes = sizeof(char*) + 2 * sizeof(size_t);
+  static const size_t kShortCapacity = kRepBytes - 2;
+  static const size_t kLongFlag = size_t(1) << (sizeof(size_t) * 8 - 1);
+  // Move assignment can only fail when it has to copy into a buffer from a
+  // different allocator.
+  static constexpr bool kNothrowMoveAssign =
+      alloc_traits::propagate_on_container_move_assignment::value ||
+      alloc_traits::is_always_equal::value;
+
+  bool IsLong() const;
+  char* Buffer() const;
+  char* ShortBuffer() const;
+  void SetSize(size_t new_size);
+  void Append(const char* str, size_t size);
+  void Prepend(const char* str, size_t size);
+  // Takes over the buffer of str2 and leaves it empty. The allocators must
+  // compare equal or be propagated by the caller.
+  void StealFrom(BasicString& str2);
+  // Capacity for a string that must hold at least min_cap characters: grows
+  // geometrically, so a run of appends reallocates O(log n) times.
+  size_t GrownCapacity(size_t min_cap) const;
+  void Reallocate(size_t new_cap);
+  char* Allocate(size_t cap);
+  void Release();
+
+  char* str_ = nullptr;
+  size_t size_ = 0;
+  size_t capacity_ = 0;
+  [[no_unique_address]] Allocator alloc_ = Allocator();
+};
+
+using String = BasicString<>;
+
+// Smallest block operator>> asks the stream buffer for at once.
+const size_t kStringReadChunk = size_t(1) << 16;
+
+namespace pmr {
+// String whose long buffers come from a std::pmr::memory_resource, e.g. a
+// monotonic arena.
+using String = BasicString<std::pmr::polymorphic_allocator<char>>;
+}  // namespace pmr
+
+static_assert(std::endian::native == std::endian::little,
+              "String packs its short mode for little-endian targets");
+static_assert(sizeof(String) == 24, "String layout changed");
+
+template <typename Allocator>
+struct std::hash<BasicString<Allocator>> {
+  size_t operator()(const BasicString<Allocator>& str) const {
+    return HashBytes(str.Data(), str.Size());
+  }
 };
 
-bool operator>(const String& str1, const String& str2);
-bool operator<(const String& str1, const String& str2);
-bool operator<=(const String& str1, const String& str2);
-bool operator>=(const String& str1, const String& str2);
-bool operator==(const String& str1, const String& str2);
-bool operator!=(const String& str1, const String& str2);
-String operator+(const String& str1, const String& str2);
-String operator*(const String& str, size_t n);
-std::ostream& operator<<(std::ostream& ostream, const String& str2);
-std::istream& operator>>(std::istream& istream, String& str2);
\ No newline at end of file
+template <typename Allocator>
+BasicString<Allocator>::BasicString(const Allocator& alloc) : alloc_(alloc) {}
+
+template <typename Allocator>
+BasicString<Allocator>::BasicString(size_t size, char character,
+                                    const Allocator& alloc)
+    : alloc_(alloc) {
+  Reserve(size);
+  std::memset(Buffer(), character, size);
+  SetSize(size);
+}
+
+template <typename Allocator>
+BasicString<Allocator>::BasicString(const char* str, const Allocator& alloc)
+    : BasicString(str, strlen(str), alloc) {}
+
+template <typename Allocator>
+BasicString<Allocator>::BasicString(const char* str, size_t size,
+                                    const Allocator& alloc)
+    : alloc_(alloc) {
+  Append(str, size);
+}
+
+template <typename Allocator>
+BasicString<Allocator>::BasicString(StringView str, const Allocator& alloc)
+    : BasicString(str.Data(), str.Size(), alloc) {}
+
+template <typename Allocator>
+BasicString<Allocator>::BasicString(const BasicString& str2)
+    : BasicString(str2,
+                  alloc_traits::select_on_container_copy_construction(
+                      str2.alloc_)) {}
+
+template <typename Allocator>
+BasicString<Allocator>::BasicString(const BasicString& str2,
+                                    const Allocator& alloc)
+    : alloc_(alloc) {
+  if (!str2.IsLong()) {
+    std::memcpy(ShortBuffer(), str2.ShortBuffer(), kRepBytes);
+    return;
+  }
+  Append(str2.Buffer(), str2.Size());
+}
+
+template <typename Allocator>
+BasicString<Allocator>::BasicString(BasicString&& str2) noexcept
+    : alloc_(std::move(str2.alloc_)) {
+  StealFrom(str2);
+}
+
+template <typename Allocator>
+BasicString<Allocator>& BasicString<Allocator>::operator=(
+    const BasicString& str2) {
+  if (&str2 == this) {
+    return *this;
+  }
+  if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+    if (alloc_ != str2.alloc_) {
+      Release();
+      capacity_ = 0;
+      SetSize(0);
+    }
+    alloc_ = str2.alloc_;
+  }
+  if (!IsLong() && !str2.IsLong()) {
+    std::memcpy(ShortBuffer(), str2.ShortBuffer(), kRepBytes);
+    return *this;
+  }
+  SetSize(0);
+  Append(str2.Buffer(), str2.Size());
+  return *this;
+}
+
+template <typename Allocator>
+BasicString<Allocator>& BasicString<Allocator>::operator=(
+    BasicString&& str2) noexcept(kNothrowMoveAssign) {
+  if (&str2 == this) {
+    return *this;
+  }
+  if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+    Release();
+    alloc_ = std::move(str2.alloc_);
+  } else if (alloc_ == str2.alloc_) {
+    Release();
+  } else {
+    // The buffer belongs to a different allocator, so only the contents can
+    // move.
+    *this = static_cast<const BasicString&>(str2);
+    return *this;
+  }
+  StealFrom(str2);
+  return *this;
+}
+
+template <typename Allocator>
+void BasicString<Allocator>::StealFrom(BasicString& str2) {
+  std::memcpy(ShortBuffer(), str2.ShortBuffer(), kRepBytes);
+  str2.capacity_ = 0;
+  str2.SetSize(0);
+}
+
+template <typename Allocator>
+BasicString<Allocator>::~BasicString() {
+  Release();
+}
+
+template <typename Allocator>
+bool BasicString<Allocator>::IsLong() const {
+  return (capacity_ & kLongFlag) != 0;
+}
+
+template <typename Allocator>
+char* BasicString<Allocator>::ShortBuffer() const {
+  return reinterpret_cast<char*>(const_cast<char**>(&str_));
+}
+
+template <typename Allocator>
+char* BasicString<Allocator>::Buffer() const {
+  return IsLong() ? str_ : ShortBuffer();
+}
+
+template <typename Allocator>
+void BasicString<Allocator>::SetSize(size_t new_size) {
+  if (IsLong()) {
+    size_ = new_size;
+  } else {
+    ShortBuffer()[kRepBytes - 1] = static_cast<char>(new_size);
+  }
+  Buffer()[new_size] = '\0';
+}
+
+template <typename Allocator>
+char* BasicString<Allocator>::Allocate(size_t cap) {
+  return alloc_traits::allocate(alloc_, cap + 1);
+}
+
+template <typename Allocator>
+void BasicString<Allocator>::Release() {
+  if (IsLong()) {
+    alloc_traits::deallocate(alloc_, str_, Capacity() + 1);
+  }
+}
+
+template <typename Allocator>
+size_t BasicString<Allocator>::GrownCapacity(size_t min_cap) const {
+  return std::max(min_cap, Capacity() * 2);
+}
+
+// Moves the contents into a heap buffer of exactly new_cap characters, or
+// back into the object when they fit there.
+template <typename Allocator>
+void BasicString<Allocator>::Reallocate(size_t new_cap) {
+  size_t size = Size();
+  if (new_cap <= kShortCapacity) {
+    if (!IsLong()) {
+      return;
+    }
+    char* old = str_;
+    size_t old_cap = Capacity();
+    capacity_ = 0;
+    std::memcpy(ShortBuffer(), old, size);
+    SetSize(size);
+    alloc_traits::deallocate(alloc_, old, old_cap + 1);
+    return;
+  }
+  char* new_str = Allocate(new_cap);
+  std::memcpy(new_str, Buffer(), size);
+  Release();
+  str_ = new_str;
+  capacity_ = new_cap | kLongFlag;
+  SetSize(size);
+}
+
+template <typename Allocator>
+void BasicString<Allocator>::Append(const char* str, size_t size) {
+  size_t old_size = Size();
+  size_t new_size = old_size + size;
+  if (new_size <= Capacity()) {
+    std::memcpy(Buffer() + old_size, str, size);
+    SetSize(new_size);
+    return;
+  }
+  // str may point into this string, so it is read before the old buffer is
+  // released.
+  size_t new_cap = GrownCapacity(new_size);
+  char* new_str = Allocate(new_cap);
+  std::memcpy(new_str, Buffer(), old_size);
+  std::memcpy(new_str + old_size, str, size);
+  Release();
+  str_ = new_str;
+  capacity_ = new_cap | kLongFlag;
+  SetSize(new_size);
+}
+
+template <typename Allocator>
+void BasicString<Allocator>::Prepend(const char* str, size_t size) {
+  size_t old_size = Size();
+  size_t new_size = old_size + size;
+  if (new_size <= Capacity()) {
+    std::memmove(Buffer() + size, Buffer(), old_size);
+    std::memcpy(Buffer(), str, size);
+    SetSize(new_size);
+    return;
+  }
+  size_t new_cap = GrownCapacity(new_size);
+  char* new_str = Allocate(new_cap);
+  std::memcpy(new_str, str, size);
+  std::memcpy(new_str + size, Buffer(), old_size);
+  Release();
+  str_ = new_str;
+  capacity_ = new_cap | kLongFlag;
+  SetSize(new_size);
+}
+
+template <typename Allocator>
+void BasicString<Allocator>::Clear() {
+  SetSize(0);
+}
+
+template <typename Allocator>
+void BasicString<Allocator>::PushBack(char character) {
+  size_t size = Size();
+  if (size == Capacity()) {
+    Reallocate(GrownCapacity(size + 1));
+  }
+  Buffer()[size] = character;
+  SetSize(size + 1);
+}
+
+template <typename Allocator>
+void BasicString<Allocator>::PopBack() {
+  if (Size() == 0) {
+    return;
+  }
+  SetSize(Size() - 1);
+}
+
+template <typename Allocator>
+void BasicString<Allocator>::Resize(size_t new_size) {
+  Resize(new_size, '\0');
+}
+
+template <typename Allocator>
+void BasicString<Allocator>::Resize(size_t new_size, char character) {
+  size_t size_before = Size();
+  if (new_size > Capacity()) {
+    Reallocate(GrownCapacity(new_size));
+  }
+  if (new_size > size_before) {
+    std::memset(Buffer() + size_before, character, new_size - size_before);
+  }
+  SetSize(new_size);
+}
+
+template <typename Allocator>
+void BasicString<Allocator>::Reserve(size_t new_cap) {
+  if (new_cap > Capacity()) {
+    Reallocate(new_cap);
+  }
+}
+
+template <typename Allocator>
+void BasicString<Allocator>::ShrinkToFit() {
+  if (Capacity() > Size()) {
+    Reallocate(Size());
+  }
+}
+
+template <typename Allocator>
+template <typename Op>
+void BasicString<Allocator>::ResizeAndOverwrite(size_t count, Op op) {
+  if (count > Capacity()) {
+    Reallocate(GrownCapacity(count));
+  }
+  SetSize(static_cast<size_t>(op(Buffer(), count)));
+}
+
+template <typename Allocator>
+void BasicString<Allocator>::Swap(BasicString& other) {
+  if constexpr (alloc_traits::propagate_on_container_swap::value) {
+    std::swap(alloc_, other.alloc_);
+  }
+  std::swap(capacity_, other.capacity_);
+  std::swap(size_, other.size_);
+  std::swap(str_, other.str_);
+}
+
+template <typename Allocator>
+const char& BasicString<Allocator>::operator[](int index) const {
+  return Buffer()[index];
+}
+
+template <typename Allocator>
+char& BasicString<Allocator>::operator[](int index) {
+  return Buffer()[index];
+}
+
+template <typename Allocator>
+const char& BasicString<Allocator>::Front() const {
+  return Buffer()[0];
+}
+
+template <typename Allocator>
+char& BasicString<Allocator>::Front() {
+  return Buffer()[0];
+}
+
+template <typename Allocator>
+const char& BasicString<Allocator>::Back() const {
+  return Buffer()[Size() - 1];
+}
+
+template <typename Allocator>
+char& BasicString<Allocator>::Back() {
+  return Buffer()[Size() - 1];
+}
+
+template <typename Allocator>
+bool BasicString<Allocator>::Empty() const {
+  return Size() == 0;
+}
+
+template <typename Allocator>
+size_t BasicString<Allocator>::Size() const {
+  if (IsLong()) {
+    return size_;
+  }
+  return static_cast<unsigned char>(ShortBuffer()[kRepBytes - 1]);
+}
+
+template <typename Allocator>
+size_t BasicString<Allocator>::Capacity() const {
+  return IsLong() ? capacity_ & ~kLongFlag : kShortCapacity;
+}
+
+template <typename Allocator>
+char* BasicString<Allocator>::Data() {
+  return Buffer();
+}
+
+template <typename Allocator>
+const char* BasicString<Allocator>::Data() const {
+  return Buffer();
+}
+
+template <typename Allocator>
+StringView BasicString<Allocator>::View() const {
+  return StringView(Buffer(), Size());
+}
+
+template <typename Allocator>
+BasicString<Allocator>::operator StringView() const {
+  return View();
+}
+
+template <typename Allocator>
+void BasicString<Allocator>::NewSizeAndCap(const BasicString& str1,
+                                           const BasicString& str2) {
+  Clear();
+  Reserve(str1.Size() + str2.Size());
+  SetSize(str1.Size() + str2.Size());
+}
+
+template <typename Allocator>
+BasicString<Allocator>& BasicString<Allocator>::operator+=(
+    const BasicString& str2) {
+  Append(str2.Buffer(), str2.Size());
+  return *this;
+}
+
+template <typename Allocator>
+BasicString<Allocator>& BasicString<Allocator>::operator+=(char str) {
+  PushBack(str);
+  return *this;
+}
+
+template <typename Allocator>
+BasicString<Allocator>& BasicString<Allocator>::Append(StringView str) {
+  Append(str.Data(), str.Size());
+  return *this;
+}
+
+template <typename Allocator>
+BasicString<Allocator> operator*(const BasicString<Allocator>& str,
+                                 size_t num) {
+  BasicString<Allocator> res(str.get_allocator());
+  size_t new_num = num;
+  if (num < 2) {
+    if (num == 0) {
+      return res;
+    }
+    return str;
+  }
+  num /= 2;
+  res = str * num;
+  res += res;
+  if (new_num % 2 != 0) {
+    return res += str;
+  }
+  return res;
+}
+
+template <typename Allocator>
+BasicString<Allocator>& BasicString<Allocator>::operator*=(size_t n) {
+  *this = *this * n;
+  return *this;
+}
+
+template <typename Allocator>
+std::ostream& operator<<(std::ostream& ostream,
+                         const BasicString<Allocator>& str2) {
+  ostream << str2.ReturnStr();
+  return ostream;
+}
+
+// Appends everything left in the stream. Reads go straight from the
+// stream buffer into the string with sgetn, in blocks that grow with the
+// string, instead of one get() per character. The first block also covers
+// whatever in_avail() promises, which for string streams and regular files
+// is everything, so those need a single allocation.
+template <typename Allocator>
+std::istream& operator>>(std::istream& istream, BasicString<Allocator>& str2) {
+  std::istream::sentry sentry(istream, true);
+  if (!sentry) {
+    return istream;
+  }
+  std::streambuf* buf = istream.rdbuf();
+  std::ios::iostate state = std::ios::goodbit;
+  size_t start = str2.Size();
+  try {
+    for (;;) {
+      size_t size = str2.Size();
+      size_t room = std::max(str2.Capacity() - size,
+                             std::max(size, kStringReadChunk));
+      std::streamsize avail = buf->in_avail();
+      if (avail > 0) {
+        // One more byte, so a read that drains the stream comes up short
+        // and ends the loop without another round.
+        room = std::max(room, static_cast<size_t>(avail) + 1);
+      }
+      std::streamsize got = 0;
+      str2.ResizeAndOverwrite(size + room, [&](char* data, size_t) {
+        got = buf->sgetn(data + size, static_cast<std::streamsize>(room));
+        return size + static_cast<size_t>(got);
+      });
+      if (static_cast<size_t>(got) < room) {
+        state |= std::ios::eofbit;
+        break;
+      }
+    }
+  } catch (...) {
+    state |= std::ios::badbit;
+  }
+  if (str2.Size() == start) {
+    state |= std::ios::failbit;
+  }
+  istream.setstate(state);
+  return istream;
+}
+
+template <typename Allocator>
+size_t BasicString<Allocator>::Find(StringView needle, size_t pos) const {
+  return View().Find(needle, pos);
+}
+
+template <typename Allocator>
+std::vector<size_t> BasicString<Allocator>::FindAll(StringView needle) const {
+  return View().FindAll(needle);
+}
+
+// Copies the tokens of View().Split(delim); tokens of up to kShortCapacity
+// characters do not allocate at all.
+template <typename Allocator>
+std::vector<BasicString<Allocator>> BasicString<Allocator>::Split(
+    StringView delim) {
+  std::vector<BasicString> result;
+  for (StringView token : View().Split(delim)) {
+    result.emplace_back(token.Data(), token.Size(), alloc_);
+  }
+  return result;
+}
+
+template <typename Allocator>
+BasicString<Allocator> BasicString<Allocator>::Join(
+    const std::vector<BasicString>& strings) const {
+  if (strings.empty()) {
+    return BasicString(alloc_);
+  }
+  // Sized up front, so every piece is copied exactly once.
+  size_t total = Size() * (strings.size() - 1);
+  for (const BasicString& str : strings) {
+    total += str.Size();
+  }
+  BasicString res(alloc_);
+  res.Reserve(total);
+  for (size_t i = 0; i < strings.size(); i++) {
+    if (i != 0) {
+      res.Append(View());
+    }
+    res.Append(strings[i].View());
+  }
+  return res;
+}
+
+template <typename Allocator>
+char* BasicString<Allocator>::ReturnStr() const {
+  return Buffer();
+}
+
+template <typename Allocator>
+size_t BasicString<Allocator>::ReturnSize() const {
+  return Size();
+}
@@ -0,0 +1,264 @@
+// Benchmark suite for the String module.
+//
+//   g++ -std=c++20 -O3 -march=native StringBenchmark.cpp -o bench
+//   ./bench [--size-mb=64] [--strings=10000000] [--min-time=0.2]
+//
+// Every case is timed until min-time seconds have elapsed and reported as
+// nanoseconds per call and input throughput in GB/s. The hash and sort cases
+// run over a vector of --strings keys cut from the text; sort is timed once
+// on a fresh copy. The split cases also report heap allocations per token,
+// counted by the global operator new below.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "String.hpp"
+#include "StringIO.hpp"
+#include "StringText.hpp"
+#include "MultiMatcher.hpp"
+#include "ParallelSplit.hpp"
+
+namespace {
+
+std::atomic<size_t> allocations{0};
+
+struct Options {
+  size_t size_mb = 64;
+  size_t strings = 10000000;
+  double min_time = 0.2;
+};
+
+template <typename F>
+double Measure(const Options& options, F&& func) {
+  func();
+  size_t iterations = 0;
+  size_t batch = 1;
+  auto start = std::chrono::steady_clock::now();
+  double elapsed = 0;
+  do {
+    for (size_t i = 0; i < batch; ++i) {
+      func();
+    }
+    iterations += batch;
+    batch *= 2;
+    elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                            start)
+                  .count();
+  } while (elapsed < options.min_time);
+  return elapsed * 1e9 / iterations;
+}
+
+// Keeps the compiler from discarding a computed value.
+template <typename T>
+void Keep(const T& value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+void Report(const char* name, double bytes, double ns_per_call) {
+  std::printf("%-24s %14.1f %9.2f\n", name, ns_per_call, bytes / ns_per_call);
+}
+
+void Report(const char* name, double bytes, double ns_per_call,
+            double allocations_per_token) {
+  std::printf("%-24s %14.1f %9.2f %12.4f\n", name, ns_per_call,
+              bytes / ns_per_call, allocations_per_token);
+}
+
+// Heap allocations made by one call of split, per token it returns.
+template <typename F>
+double AllocationsPerToken(F&& split) {
+  size_t before = allocations.load();
+  size_t tokens = split().size();
+  return double(allocations.load() - before) / double(tokens);
+}
+
+// Log-like text: space separated words of lowercase letters, comma
+// separated fields, one record per line.
+String MakeText(size_t size) {
+  String text;
+  text.Reserve(size);
+  uint64_t state = 88172645463325252ull;
+  while (text.Size() < size) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    size_t word = 2 + state % 9;
+    for (size_t i = 0; i < word; ++i) {
+      text.PushBack(static_cast<char>('a' + (state >> (i * 5)) % 26));
+    }
+    uint64_t sep = (state >> 48) % 16;
+    text.PushBack(sep == 0 ? '\n' : sep < 4 ? ',' : ' ');
+  }
+  return text;
+}
+
+Options ParseOptions(int argc, char** argv) {
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    size_t eq = arg.find('=');
+    std::string key = arg.substr(0, eq);
+    std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+    if (key == "--size-mb") {
+      options.size_mb = std::stoul(value);
+    } else if (key == "--strings") {
+      options.strings = std::stoul(value);
+    } else if (key == "--min-time") {
+      options.min_time = std::stod(value);
+    } else {
+      std::cerr << "unknown option " << arg << "\n";
+      std::exit(2);
+    }
+  }
+  return options;
+}
+
+}  // namespace
+
+void* operator new(size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+// GCC cannot see that these pair with the malloc-based operator new above.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, size_t /*unused*/) noexcept { std::free(ptr); }
+#pragma GCC diagnostic pop
+
+int main(int argc, char** argv) {
+  Options options = ParseOptions(argc, argv);
+  String text = MakeText(options.size_mb << 20);
+  StringView view = text;
+  double bytes = double(view.Size());
+
+  std::printf("%-24s %14s %9s %12s\n", "case", "ns/call", "GB/s",
+              "allocs/token");
+  // Needles that never occur, so every call scans the whole text.
+  Report("find_char", bytes,
+         Measure(options, [&] { Keep(view.Find('#')); }));
+  Report("find_short", bytes,
+         Measure(options, [&] { Keep(view.Find("qzxj#")); }));
+  Report("find_long", bytes, Measure(options, [&] {
+           Keep(view.Find("abcdefghijklmnopqrstuvwxyz0123456789#"));
+         }));
+  Report("find_first_of", bytes,
+         Measure(options, [&] { Keep(view.FindFirstOf("#$%^&")); }));
+  Report("split_view", bytes, Measure(options, [&] {
+           size_t tokens = 0;
+           for (StringView token : view.Split(",")) {
+             tokens += token.Size();
+           }
+           Keep(tokens);
+         }));
+  Report("split_any_view", bytes, Measure(options, [&] {
+           size_t tokens = 0;
+           for (StringView token : view.SplitAny(" ,\n")) {
+             tokens += token.Size();
+           }
+           Keep(tokens);
+         }));
+  auto split = [&] { return text.Split(","); };
+  Report("split", bytes, Measure(options, [&] { Keep(split().size()); }),
+         AllocationsPerToken(split));
+  // Words of 2 to 10 bytes, which all fit the short mode.
+  String words = text;
+  std::replace(words.Data(), words.Data() + words.Size(), ',', ' ');
+  std::replace(words.Data(), words.Data() + words.Size(), '\n', ' ');
+  auto split_words = [&] { return words.Split(" "); };
+  Report("split_short", bytes,
+         Measure(options, [&] { Keep(split_words().size()); }),
+         AllocationsPerToken(split_words));
+  Report("parallel_split", bytes,
+         Measure(options, [&] { Keep(ParallelSplit(view, ",").size()); }));
+  Report("validate_utf8", bytes,
+         Measure(options, [&] { Keep(ValidateUtf8(view)); }));
+  String upper = text;
+  Report("to_upper_ascii", bytes, Measure(options, [&] {
+           ToUpperAscii(upper);
+           Keep(upper.Data()[0]);
+         }));
+  Report("hash_text", bytes,
+         Measure(options, [&] { Keep(HashBytes(view.Data(), view.Size())); }));
+  // 200 distinct words of the text as keywords, so matches are frequent.
+  std::vector<StringView> keywords;
+  for (StringView word : view.SplitAny(" ,\n")) {
+    if (keywords.size() == 200) {
+      break;
+    }
+    if (word.Size() >= 6 &&
+        std::find(keywords.begin(), keywords.end(), word) == keywords.end()) {
+      keywords.push_back(word);
+    }
+  }
+  MultiMatcher matcher(keywords);
+  Report("multi_match", bytes, Measure(options, [&] {
+           size_t matches = 0;
+           matcher.Scan(view, [&](const MultiMatcher::Match&) { ++matches; });
+           Keep(matches);
+         }));
+  std::string stream_text(view.Data(), view.Size());
+  Report("stream_extract", bytes, Measure(options, [&] {
+           std::istringstream in(stream_text);
+           String res;
+           in >> res;
+           Keep(res.Size());
+         }));
+  Report("get_line", bytes, Measure(options, [&] {
+           std::istringstream in(stream_text);
+           String line;
+           size_t lines = 0;
+           while (GetLine(in, line)) {
+             lines += line.Size();
+           }
+           Keep(lines);
+         }));
+
+  // Keys of 1 to 64 bytes taken from the text, so most fit the short mode.
+  std::vector<String> keys;
+  keys.reserve(options.strings);
+  double key_bytes = 0;
+  for (size_t i = 0, pos = 0; i < options.strings; ++i) {
+    size_t size = 1 + (i * 2654435761u >> 7) % 64;
+    if (pos + size > view.Size()) {
+      pos = 0;
+    }
+    keys.emplace_back(view.Substr(pos, size));
+    key_bytes += double(size);
+    pos += size;
+  }
+  Report("hash_keys", key_bytes, Measure(options, [&] {
+           std::hash<String> hasher;
+           size_t sum = 0;
+           for (const String& key : keys) {
+             sum += hasher(key);
+           }
+           Keep(sum);
+         }));
+  Report("unordered_set_insert", key_bytes, Measure(options, [&] {
+           std::unordered_set<String> set(keys.begin(), keys.end());
+           Keep(set.size());
+         }));
+  std::vector<String> copy = keys;
+  auto start = std::chrono::steady_clock::now();
+  std::sort(copy.begin(), copy.end());
+  Report("sort_keys", key_bytes,
+         std::chrono::duration<double, std::nano>(
+             std::chrono::steady_clock::now() - start)
+             .count());
+  Keep(copy.front().Size());
+}
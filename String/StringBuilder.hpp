@@ -0,0 +1,136 @@
+#pragma once
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "String.hpp"
+
+// Accumulates pieces into a list of chunks that grow geometrically and are
+// never moved, so appending costs one memcpy per byte however large the
+// result gets. Finish() then copies every chunk once into a String of the
+// exact final size.
+template <typename Allocator = std::allocator<char>>
+class BasicStringBuilder {
+  using alloc_traits = std::allocator_traits<Allocator>;
+
+ public:
+  BasicStringBuilder() = default;
+  explicit BasicStringBuilder(const Allocator& alloc);
+  BasicStringBuilder(const BasicStringBuilder&) = delete;
+  BasicStringBuilder& operator=(const BasicStringBuilder&) = delete;
+  ~BasicStringBuilder();
+
+  BasicStringBuilder& Append(StringView str);
+  BasicStringBuilder& Append(char character);
+  BasicStringBuilder& operator<<(StringView str);
+  BasicStringBuilder& operator<<(char character);
+
+  size_t Size() const;
+  // Returns everything appended so far and leaves the builder empty.
+  BasicString<Allocator> Finish();
+
+ private:
+  static constexpr size_t kFirstChunk = 256;
+  static constexpr size_t kMaxChunk = size_t(1) << 20;
+
+  struct Chunk {
+    char* data;
+    size_t size;
+    size_t capacity;
+  };
+
+  void AddChunk(size_t min_cap);
+  void Release();
+
+  std::vector<Chunk> chunks_;
+  size_t size_ = 0;
+  [[no_unique_address]] Allocator alloc_ = Allocator();
+};
+
+using StringBuilder = BasicStringBuilder<>;
+
+template <typename Allocator>
+BasicStringBuilder<Allocator>::BasicStringBuilder(const Allocator& alloc)
+    : alloc_(alloc) {}
+
+template <typename Allocator>
+BasicStringBuilder<Allocator>::~BasicStringBuilder() {
+  Release();
+}
+
+template <typename Allocator>
+void BasicStringBuilder<Allocator>::AddChunk(size_t min_cap) {
+  size_t cap = chunks_.empty()
+                   ? kFirstChunk
+                   : std::min(chunks_.back().capacity * 2, kMaxChunk);
+  cap = std::max(cap, min_cap);
+  chunks_.push_back(Chunk{alloc_traits::allocate(alloc_, cap), 0, cap});
+}
+
+template <typename Allocator>
+void BasicStringBuilder<Allocator>::Release() {
+  for (const Chunk& chunk : chunks_) {
+    alloc_traits::deallocate(alloc_, chunk.data, chunk.capacity);
+  }
+  chunks_.clear();
+  size_ = 0;
+}
+
+template <typename Allocator>
+BasicStringBuilder<Allocator>& BasicStringBuilder<Allocator>::Append(
+    StringView str) {
+  size_t done = 0;
+  while (done < str.Size()) {
+    if (chunks_.empty() || chunks_.back().size == chunks_.back().capacity) {
+      AddChunk(str.Size() - done);
+    }
+    Chunk& chunk = chunks_.back();
+    size_t count = std::min(str.Size() - done, chunk.capacity - chunk.size);
+    std::memcpy(chunk.data + chunk.size, str.Data() + done, count);
+    chunk.size += count;
+    done += count;
+  }
+  size_ += str.Size();
+  return *this;
+}
+
+template <typename Allocator>
+BasicStringBuilder<Allocator>& BasicStringBuilder<Allocator>::Append(
+    char character) {
+  if (chunks_.empty() || chunks_.back().size == chunks_.back().capacity) {
+    AddChunk(1);
+  }
+  Chunk& chunk = chunks_.back();
+  chunk.data[chunk.size++] = character;
+  ++size_;
+  return *this;
+}
+
+template <typename Allocator>
+BasicStringBuilder<Allocator>& BasicStringBuilder<Allocator>::operator<<(
+    StringView str) {
+  return Append(str);
+}
+
+template <typename Allocator>
+BasicStringBuilder<Allocator>& BasicStringBuilder<Allocator>::operator<<(
+    char character) {
+  return Append(character);
+}
+
+template <typename Allocator>
+size_t BasicStringBuilder<Allocator>::Size() const {
+  return size_;
+}
+
+template <typename Allocator>
+BasicString<Allocator> BasicStringBuilder<Allocator>::Finish() {
+  BasicString<Allocator> res(alloc_);
+  res.Reserve(size_);
+  for (const Chunk& chunk : chunks_) {
+    res.Append(StringView(chunk.data, chunk.size));
+  }
+  Release();
+  return res;
+}
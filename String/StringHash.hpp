@@ -0,0 +1,131 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+const uint64_t kHashMultiplier = 0x9e3779b97f4a7c15ull;
+const uint32_t kHashScramble = 0x9e3779b1u;
+
+// Inputs longer than this go through the striped accumulator below.
+const size_t kHashShortInput = 32;
+const size_t kHashStripe = 32;
+const size_t kHashStripesPerBlock = 8;
+
+// Per-stripe keys. Stripe s of a block is mixed with words s..s+3, the last
+// stripe of the input with words 8..11.
+alignas(32) const uint64_t kHashSecret[12] = {
+    0x2cb0f69f4abea221ull, 0x9417034723148989ull, 0xdd555950609dfe03ull,
+    0xdbafb150deb12800ull, 0x7e789b2e6c442cb6ull, 0xf41e5636c7e4f8c4ull,
+    0x0959d150f8fba7e4ull, 0xa97316f13cdb9eeaull, 0x74cd8258f9520068ull,
+    0x55c74a62e116868bull, 0xd2f4c799a2023cbdull, 0xdf98cb79a37b51b9ull,
+};
+
+// Final avalanche of MurmurHash3, so every input bit affects every output
+// bit.
+inline uint64_t HashMix(uint64_t value) {
+  value ^= value >> 33;
+  value *= 0xff51afd7ed558ccdull;
+  value ^= value >> 33;
+  value *= 0xc4ceb9fe1a85ec53ull;
+  value ^= value >> 33;
+  return value;
+}
+
+// Four 64-bit lanes, one 32-byte stripe per step, in the style of XXH3: lane
+// j adds lo32(d ^ k) * hi32(d ^ k) of its own word and the raw word of lane
+// j ^ 1. Each 32x32->64 product is one vpmuludq lane, so AVX2 does a whole
+// stripe in a handful of instructions. After each block of eight stripes the
+// lanes are scrambled, so stripes cannot be reordered without changing the
+// hash. The scalar path computes exactly the same values.
+#if defined(__AVX2__)
+struct HashLanes {
+  __m256i acc = _mm256_setr_epi64x(
+      static_cast<int64_t>(kHashMultiplier), 0x85ebca6b, 0xc2b2ae35,
+      static_cast<int64_t>(0x27d4eb2f165667c5ull));
+
+  void Accumulate(const char* stripe, const uint64_t* secret) {
+    __m256i data =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(stripe));
+    __m256i key = _mm256_xor_si256(
+        data, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(secret)));
+    __m256i product = _mm256_mul_epu32(key, _mm256_srli_epi64(key, 32));
+    __m256i swapped = _mm256_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+    acc = _mm256_add_epi64(acc, _mm256_add_epi64(product, swapped));
+  }
+
+  void Scramble() {
+    acc = _mm256_xor_si256(acc, _mm256_srli_epi64(acc, 47));
+    __m256i prime = _mm256_set1_epi32(static_cast<int>(kHashScramble));
+    __m256i low = _mm256_mul_epu32(acc, prime);
+    __m256i high = _mm256_mul_epu32(_mm256_srli_epi64(acc, 32), prime);
+    acc = _mm256_add_epi64(low, _mm256_slli_epi64(high, 32));
+  }
+
+  void Store(uint64_t* lanes) const {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), acc);
+  }
+};
+#else
+struct HashLanes {
+  uint64_t acc[4] = {kHashMultiplier, 0x85ebca6b, 0xc2b2ae35,
+                     0x27d4eb2f165667c5ull};
+
+  void Accumulate(const char* stripe, const uint64_t* secret) {
+    uint64_t data[4];
+    std::memcpy(data, stripe, sizeof(data));
+    for (size_t j = 0; j < 4; ++j) {
+      uint64_t key = data[j] ^ secret[j];
+      acc[j] += (key & 0xffffffffu) * (key >> 32) + data[j ^ 1];
+    }
+  }
+
+  void Scramble() {
+    for (uint64_t& lane : acc) {
+      lane = (lane ^ (lane >> 47)) * kHashScramble;
+    }
+  }
+
+  void Store(uint64_t* lanes) const { std::memcpy(lanes, acc, sizeof(acc)); }
+};
+#endif
+
+// 64-bit hash of a byte range. Short inputs take eight bytes per step;
+// longer ones go through HashLanes.
+inline uint64_t HashBytes(const char* data, size_t size) {
+  uint64_t hash = size * kHashMultiplier;
+  if (size > kHashShortInput) {
+    HashLanes lanes;
+    size_t stripes = (size - 1) / kHashStripe;
+    for (size_t s = 0; s < stripes; ++s) {
+      lanes.Accumulate(data + s * kHashStripe,
+                       kHashSecret + s % kHashStripesPerBlock);
+      if (s % kHashStripesPerBlock == kHashStripesPerBlock - 1) {
+        lanes.Scramble();
+      }
+    }
+    // The last stripe may overlap the previous one.
+    lanes.Accumulate(data + size - kHashStripe, kHashSecret + 8);
+    uint64_t acc[4];
+    lanes.Store(acc);
+    for (uint64_t lane : acc) {
+      hash = (hash ^ HashMix(lane)) * kHashMultiplier;
+    }
+    return HashMix(hash);
+  }
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    uint64_t word;
+    std::memcpy(&word, data + i, 8);
+    hash = (hash ^ HashMix(word)) * kHashMultiplier;
+  }
+  if (i < size) {
+    uint64_t word = 0;
+    std::memcpy(&word, data + i, size - i);
+    hash = (hash ^ HashMix(word)) * kHashMultiplier;
+  }
+  return HashMix(hash);
+}
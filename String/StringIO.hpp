@@ -0,0 +1,136 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <iostream>
+#include <string>
+#include <system_error>
+
+#include "String.hpp"
+
+// Smallest block GetLine hands to istream::getline at once.
+const size_t kGetLineChunk = 128;
+
+// Reads count bytes from fd into data, or fewer at end of file. Returns the
+// number read, or -1 with errno set.
+inline ssize_t ReadFully(int fd, char* data, size_t count) {
+  size_t done = 0;
+  while (done < count) {
+    ssize_t got = read(fd, data + done, count - done);
+    if (got < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return -1;
+    }
+    if (got == 0) {
+      break;
+    }
+    done += static_cast<size_t>(got);
+  }
+  return static_cast<ssize_t>(done);
+}
+
+// Whole contents of the file at path. A regular file is read with read(2)
+// into a buffer of exactly its size, one allocation and no stream buffer in
+// between. Pipes and files that report no size, like those in /proc, are
+// read in blocks that grow geometrically.
+template <typename Allocator = std::allocator<char>>
+BasicString<Allocator> ReadFile(const std::string& path,
+                                const Allocator& alloc = Allocator()) {
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    throw std::system_error(errno, std::generic_category(), path);
+  }
+  struct stat info {};
+  if (fstat(fd, &info) != 0) {
+    int error = errno;
+    close(fd);
+    throw std::system_error(error, std::generic_category(), path);
+  }
+  BasicString<Allocator> res(alloc);
+  size_t expected = S_ISREG(info.st_mode) ? size_t(info.st_size) : 0;
+  bool exact = expected != 0;
+  for (;;) {
+    size_t size = res.Size();
+    size_t room = exact ? expected
+                        : std::max(res.Capacity() - size,
+                                   std::max(size, kStringReadChunk));
+    ssize_t got = 0;
+    try {
+      res.ResizeAndOverwrite(size + room, [&](char* data, size_t) {
+        got = ReadFully(fd, data + size, room);
+        return got < 0 ? size : size + static_cast<size_t>(got);
+      });
+    } catch (...) {
+      close(fd);
+      throw;
+    }
+    if (got < 0) {
+      int error = errno;
+      close(fd);
+      throw std::system_error(error, std::generic_category(), path);
+    }
+    if (exact || static_cast<size_t>(got) < room) {
+      break;
+    }
+  }
+  close(fd);
+  return res;
+}
+
+// Reads characters up to delim into line, like std::getline: delim is
+// extracted but not stored, and failbit is set only when nothing at all was
+// extracted. line is cleared but keeps its capacity, so reading a file line
+// by line into one String allocates only when a line is longer than any
+// before it. The characters are copied by istream::getline, which scans the
+// stream buffer for delim in bulk.
+template <typename Allocator>
+std::istream& GetLine(std::istream& istream, BasicString<Allocator>& line,
+                      char delim = '\n') {
+  line.Clear();
+  // getline reports a full buffer as failbit; exceptions are held back until
+  // the whole line has been read.
+  std::ios::iostate exceptions = istream.exceptions();
+  istream.exceptions(std::ios::goodbit);
+  size_t extracted = 0;
+  // Growing line can throw; the caller's mask is restored on the way out.
+  try {
+    for (;;) {
+      size_t size = line.Size();
+      size_t room = std::max(line.Capacity() - size,
+                             std::max(size, kGetLineChunk));
+      bool full = false;
+      line.ResizeAndOverwrite(size + room, [&](char* data, size_t) {
+        // Stores at most room - 1 characters and a '\0'.
+        istream.getline(data + size, static_cast<std::streamsize>(room), delim);
+        size_t got = static_cast<size_t>(istream.gcount());
+        extracted += got;
+        if (istream.eof()) {
+          return size + got;
+        }
+        if (istream.fail()) {
+          full = got == room - 1;
+          return size + got;
+        }
+        return size + got - 1;
+      });
+      if (!full) {
+        break;
+      }
+      istream.clear(istream.rdstate() & ~std::ios::failbit);
+    }
+    if (extracted != 0 && !istream.bad()) {
+      istream.clear(istream.rdstate() & ~std::ios::failbit);
+    }
+  } catch (...) {
+    istream.exceptions(exceptions);
+    throw;
+  }
+  istream.exceptions(exceptions);
+  return istream;
+}
@@ -0,0 +1,299 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// Substring and byte-class search kernels behind StringView::Find and the
+// split ranges. They work on raw (data, size) ranges and report positions,
+// or kStringNpos when nothing matches.
+const size_t kStringNpos = static_cast<size_t>(-1);
+
+// Needles at least this long are searched with Two-Way, which is linear in
+// the worst case. Shorter needles use the first/last byte filter, whose
+// worst case is O(n * m) but which is much faster on real text.
+const size_t kTwoWayMinNeedle = 32;
+
+// Precompiled needle. Construction is O(m); Find is O(n) for long needles.
+// The needle is not copied and must outlive the searcher.
+class Searcher {
+ public:
+  Searcher() = default;
+  Searcher(const char* needle, size_t size);
+
+  size_t Find(const char* text, size_t size, size_t pos = 0) const;
+  // Length of a match, i.e. how far a split skips past it.
+  size_t MatchSize() const { return size_; }
+
+ private:
+  size_t FindShort(const char* text, size_t size, size_t pos) const;
+  size_t FindTwoWay(const char* text, size_t size, size_t pos) const;
+
+  const unsigned char* needle_ = nullptr;
+  size_t size_ = 0;
+  // Critical factorization needle = u v with |u| = critical_ + 1, and the
+  // period of the needle (exact when periodic_, a lower bound otherwise).
+  ptrdiff_t critical_ = 0;
+  size_t period_ = 0;
+  bool periodic_ = false;
+};
+
+// Set of bytes as a 256-bit bitmap, for splitting on any of several
+// delimiters. Alongside the bitmap it keeps two nibble tables so that AVX2
+// can classify 32 bytes per step with vpshufb: lookup_low_[lo] has bit h set
+// when byte (h << 4 | lo) is in the set, for h < 8, lookup_high_ for h >= 8.
+class ByteSet {
+ public:
+  ByteSet() = default;
+  ByteSet(const char* bytes, size_t size);
+
+  void Insert(unsigned char byte);
+  bool Contains(unsigned char byte) const {
+    return ((bits_[byte >> 6] >> (byte & 63)) & 1) != 0;
+  }
+
+  // Position of the first byte at or after pos that is in the set.
+  size_t Find(const char* text, size_t size, size_t pos = 0) const;
+  size_t MatchSize() const { return 1; }
+
+ private:
+  uint64_t bits_[4] = {};
+  alignas(16) uint8_t lookup_low_[16] = {};
+  alignas(16) uint8_t lookup_high_[16] = {};
+};
+
+// Maximal suffix of needle under the byte order (or its reverse); returns
+// the index before the suffix and stores its period.
+inline ptrdiff_t MaximalSuffix(const unsigned char* needle, size_t size,
+                               bool reverse, size_t* period) {
+  ptrdiff_t suffix = -1;
+  size_t j = 0;
+  size_t k = 1;
+  size_t p = 1;
+  while (j + k < size) {
+    unsigned char a = needle[j + k];
+    unsigned char b = needle[suffix + static_cast<ptrdiff_t>(k)];
+    if (reverse ? a > b : a < b) {
+      j += k;
+      k = 1;
+      p = j - suffix;
+    } else if (a == b) {
+      if (k != p) {
+        ++k;
+      } else {
+        j += p;
+        k = 1;
+      }
+    } else {
+      suffix = static_cast<ptrdiff_t>(j);
+      j = suffix + 1;
+      k = 1;
+      p = 1;
+    }
+  }
+  *period = p;
+  return suffix;
+}
+
+inline Searcher::Searcher(const char* needle, size_t size)
+    : needle_(reinterpret_cast<const unsigned char*>(needle)), size_(size) {
+  if (size_ < kTwoWayMinNeedle) {
+    return;
+  }
+  size_t period = 0;
+  size_t period_reverse = 0;
+  ptrdiff_t suffix = MaximalSuffix(needle_, size_, false, &period);
+  ptrdiff_t suffix_reverse =
+      MaximalSuffix(needle_, size_, true, &period_reverse);
+  if (suffix > suffix_reverse) {
+    critical_ = suffix;
+    period_ = period;
+  } else {
+    critical_ = suffix_reverse;
+    period_ = period_reverse;
+  }
+  periodic_ = std::memcmp(needle_, needle_ + period_, critical_ + 1) == 0;
+  if (!periodic_) {
+    period_ = std::max<size_t>(critical_ + 1, size_ - critical_ - 1) + 1;
+  }
+}
+
+inline size_t Searcher::Find(const char* text, size_t size, size_t pos) const {
+  if (pos > size || size - pos < size_) {
+    return kStringNpos;
+  }
+  if (size_ == 0) {
+    return pos;
+  }
+  if (size_ == 1) {
+    const void* found = std::memchr(text + pos, needle_[0], size - pos);
+    return found == nullptr ? kStringNpos
+                            : static_cast<const char*>(found) - text;
+  }
+  if (size_ < kTwoWayMinNeedle) {
+    return FindShort(text, size, pos);
+  }
+  return FindTwoWay(text, size, pos);
+}
+
+// Compares the first and the last byte of the needle against a whole vector
+// of candidate positions at once and runs memcmp only where both match.
+inline size_t Searcher::FindShort(const char* text, size_t size,
+                                  size_t pos) const {
+  const char* needle = reinterpret_cast<const char*>(needle_);
+  size_t last = size_ - 1;
+#if defined(__AVX2__)
+  __m256i first_byte = _mm256_set1_epi8(needle[0]);
+  __m256i last_byte = _mm256_set1_epi8(needle[last]);
+  for (; pos + last + 32 <= size; pos += 32) {
+    __m256i block_first =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + pos));
+    __m256i block_last = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(text + pos + last));
+    uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(
+        _mm256_and_si256(_mm256_cmpeq_epi8(first_byte, block_first),
+                         _mm256_cmpeq_epi8(last_byte, block_last))));
+    for (; mask != 0; mask &= mask - 1) {
+      size_t candidate = pos + std::countr_zero(mask);
+      if (std::memcmp(text + candidate + 1, needle + 1, last - 1) == 0) {
+        return candidate;
+      }
+    }
+  }
+#elif defined(__SSE2__)
+  __m128i first_byte = _mm_set1_epi8(needle[0]);
+  __m128i last_byte = _mm_set1_epi8(needle[last]);
+  for (; pos + last + 16 <= size; pos += 16) {
+    __m128i block_first =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + pos));
+    __m128i block_last =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + pos + last));
+    uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(
+        _mm_and_si128(_mm_cmpeq_epi8(first_byte, block_first),
+                      _mm_cmpeq_epi8(last_byte, block_last))));
+    for (; mask != 0; mask &= mask - 1) {
+      size_t candidate = pos + std::countr_zero(mask);
+      if (std::memcmp(text + candidate + 1, needle + 1, last - 1) == 0) {
+        return candidate;
+      }
+    }
+  }
+#endif
+  for (; pos + last < size; ++pos) {
+    const void* found = std::memchr(text + pos, needle[0], size - last - pos);
+    if (found == nullptr) {
+      return kStringNpos;
+    }
+    pos = static_cast<const char*>(found) - text;
+    if (text[pos + last] == needle[last] &&
+        std::memcmp(text + pos + 1, needle + 1, last - 1) == 0) {
+      return pos;
+    }
+  }
+  return kStringNpos;
+}
+
+// Crochemore-Perrin Two-Way matching: the right part of the critical
+// factorization is compared left to right, the left part right to left, and
+// shifts never move back, so the scan is linear with O(1) extra memory.
+inline size_t Searcher::FindTwoWay(const char* text, size_t size,
+                                   size_t pos) const {
+  const unsigned char* haystack = reinterpret_cast<const unsigned char*>(text);
+  ptrdiff_t needle_size = static_cast<ptrdiff_t>(size_);
+  ptrdiff_t period = static_cast<ptrdiff_t>(period_);
+  // Prefix of the needle already known to match after a periodic shift.
+  ptrdiff_t memory = -1;
+  for (size_t j = pos; j + size_ <= size;) {
+    if (memory < 0) {
+      // Nothing is remembered, so skip with memchr to the next window whose
+      // first byte of the right part matches. Shifts still only go forward.
+      size_t first = j + critical_ + 1;
+      const void* found = std::memchr(haystack + first, needle_[critical_ + 1],
+                                      size - size_ - j + 1);
+      if (found == nullptr) {
+        return kStringNpos;
+      }
+      j = static_cast<const unsigned char*>(found) - haystack - critical_ - 1;
+    }
+    const unsigned char* window = haystack + j;
+    ptrdiff_t i = std::max(critical_, memory) + 1;
+    while (i < needle_size && needle_[i] == window[i]) {
+      ++i;
+    }
+    if (i < needle_size) {
+      j += i - critical_;
+      memory = -1;
+      continue;
+    }
+    i = critical_;
+    while (i > memory && needle_[i] == window[i]) {
+      --i;
+    }
+    if (i <= memory) {
+      return j;
+    }
+    j += period;
+    if (periodic_) {
+      memory = needle_size - period - 1;
+    }
+  }
+  return kStringNpos;
+}
+
+inline ByteSet::ByteSet(const char* bytes, size_t size) {
+  for (size_t i = 0; i < size; ++i) {
+    Insert(static_cast<unsigned char>(bytes[i]));
+  }
+}
+
+inline void ByteSet::Insert(unsigned char byte) {
+  bits_[byte >> 6] |= uint64_t(1) << (byte & 63);
+  unsigned high = byte >> 4;
+  if (high < 8) {
+    lookup_low_[byte & 15] |= uint8_t(1u << high);
+  } else {
+    lookup_high_[byte & 15] |= uint8_t(1u << (high - 8));
+  }
+}
+
+inline size_t ByteSet::Find(const char* text, size_t size, size_t pos) const {
+#if defined(__AVX2__)
+  __m256i lookup_low = _mm256_broadcastsi128_si256(
+      _mm_load_si128(reinterpret_cast<const __m128i*>(lookup_low_)));
+  __m256i lookup_high = _mm256_broadcastsi128_si256(
+      _mm_load_si128(reinterpret_cast<const __m128i*>(lookup_high_)));
+  // Bit (h & 7) for a high nibble h.
+  __m256i high_bit = _mm256_setr_epi8(
+      1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8,
+      16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+  __m256i nibble = _mm256_set1_epi8(0x0f);
+  __m256i seven = _mm256_set1_epi8(7);
+  for (; pos + 32 <= size; pos += 32) {
+    __m256i block =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + pos));
+    __m256i low = _mm256_and_si256(block, nibble);
+    __m256i high = _mm256_and_si256(_mm256_srli_epi16(block, 4), nibble);
+    __m256i row = _mm256_blendv_epi8(_mm256_shuffle_epi8(lookup_low, low),
+                                     _mm256_shuffle_epi8(lookup_high, low),
+                                     _mm256_cmpgt_epi8(high, seven));
+    __m256i hit =
+        _mm256_and_si256(row, _mm256_shuffle_epi8(high_bit, high));
+    uint32_t mask = ~static_cast<uint32_t>(_mm256_movemask_epi8(
+        _mm256_cmpeq_epi8(hit, _mm256_setzero_si256())));
+    if (mask != 0) {
+      return pos + std::countr_zero(mask);
+    }
+  }
+#endif
+  for (; pos < size; ++pos) {
+    if (Contains(static_cast<unsigned char>(text[pos]))) {
+      return pos;
+    }
+  }
+  return kStringNpos;
+}
@@ -0,0 +1,340 @@
+#pragma once
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "String.hpp"
+#include "StringView.hpp"
+
+// Text helpers over raw bytes: UTF-8 validation, ASCII case mapping and
+// whitespace trimming. With AVX2 each takes 32 bytes per step; otherwise
+// they fall back to scalar loops that skip ASCII eight bytes at a time.
+
+// Space, \t, \n, \v, \f and \r, as isspace in the C locale.
+inline bool IsAsciiSpace(char character) {
+  return character == ' ' ||
+         static_cast<uint8_t>(character - '\t') <= '\r' - '\t';
+}
+
+// Writes size bytes of src to dst, flipping the case of the letters first
+// to first + 25. Bytes outside that range, UTF-8 included, are copied as
+// is. src and dst may be the same.
+inline void MapAsciiCase(const char* src, char* dst, size_t size,
+                         char first) {
+  size_t i = 0;
+#if defined(__AVX2__)
+  // Moves first to -128, so the letters are exactly the bytes below -102 as
+  // signed values.
+  __m256i shift = _mm256_set1_epi8(static_cast<char>(0x80 - first));
+  __m256i bound = _mm256_set1_epi8(-128 + 26);
+  __m256i flip = _mm256_set1_epi8(0x20);
+  for (; i + 32 <= size; i += 32) {
+    __m256i block =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    __m256i letters =
+        _mm256_cmpgt_epi8(bound, _mm256_add_epi8(block, shift));
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i*>(dst + i),
+        _mm256_xor_si256(block, _mm256_and_si256(letters, flip)));
+  }
+#endif
+  for (; i < size; ++i) {
+    char character = src[i];
+    bool letter = static_cast<uint8_t>(character - first) < 26;
+    dst[i] = static_cast<char>(character ^ (letter ? 0x20 : 0));
+  }
+}
+
+template <typename Allocator>
+void ToLowerAscii(BasicString<Allocator>& str) {
+  MapAsciiCase(str.Data(), str.Data(), str.Size(), 'A');
+}
+
+template <typename Allocator>
+void ToUpperAscii(BasicString<Allocator>& str) {
+  MapAsciiCase(str.Data(), str.Data(), str.Size(), 'a');
+}
+
+inline String ToLowerAsciiCopy(StringView str) {
+  String res;
+  res.ResizeAndOverwrite(str.Size(), [&](char* data, size_t size) {
+    MapAsciiCase(str.Data(), data, size, 'A');
+    return size;
+  });
+  return res;
+}
+
+inline String ToUpperAsciiCopy(StringView str) {
+  String res;
+  res.ResizeAndOverwrite(str.Size(), [&](char* data, size_t size) {
+    MapAsciiCase(str.Data(), data, size, 'a');
+    return size;
+  });
+  return res;
+}
+
+#if defined(__AVX2__)
+// 32-bit mask of the whitespace bytes of a block.
+inline uint32_t AsciiSpaceMask(__m256i block) {
+  __m256i space = _mm256_cmpeq_epi8(block, _mm256_set1_epi8(' '));
+  // \t to \r moved to -128 to -124.
+  __m256i control = _mm256_cmpgt_epi8(
+      _mm256_set1_epi8(-128 + 5),
+      _mm256_add_epi8(block, _mm256_set1_epi8(static_cast<char>(0x80 - 9))));
+  return static_cast<uint32_t>(
+      _mm256_movemask_epi8(_mm256_or_si256(space, control)));
+}
+#endif
+
+// View without leading ASCII whitespace.
+inline StringView TrimLeft(StringView str) {
+  const char* data = str.Data();
+  size_t size = str.Size();
+  size_t i = 0;
+#if defined(__AVX2__)
+  for (; i + 32 <= size; i += 32) {
+    uint32_t other = ~AsciiSpaceMask(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)));
+    if (other != 0) {
+      return str.Substr(i + std::countr_zero(other));
+    }
+  }
+#endif
+  while (i < size && IsAsciiSpace(data[i])) {
+    ++i;
+  }
+  return str.Substr(i);
+}
+
+// View without trailing ASCII whitespace.
+inline StringView TrimRight(StringView str) {
+  const char* data = str.Data();
+  size_t size = str.Size();
+#if defined(__AVX2__)
+  for (; size >= 32; size -= 32) {
+    uint32_t other = ~AsciiSpaceMask(_mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(data + size - 32)));
+    if (other != 0) {
+      return StringView(data, size - std::countl_zero(other));
+    }
+  }
+#endif
+  while (size > 0 && IsAsciiSpace(data[size - 1])) {
+    --size;
+  }
+  return StringView(data, size);
+}
+
+inline StringView Trim(StringView str) { return TrimLeft(TrimRight(str)); }
+
+// Checks one multi-byte sequence of a UTF-8 string starting at data[i] and
+// returns its size, or 0 when it is not well formed: overlong forms,
+// surrogates, code points past U+10FFFF and truncated sequences all fail.
+inline size_t Utf8SequenceSize(const uint8_t* data, size_t size, size_t i) {
+  uint8_t lead = data[i];
+  size_t count = 0;
+  // Bounds of the second byte, which rule out the overlong, surrogate and
+  // too large forms.
+  uint8_t low = 0x80;
+  uint8_t high = 0xbf;
+  if (lead >= 0xc2 && lead <= 0xdf) {
+    count = 2;
+  } else if (lead >= 0xe0 && lead <= 0xef) {
+    count = 3;
+    low = lead == 0xe0 ? 0xa0 : 0x80;
+    high = lead == 0xed ? 0x9f : 0xbf;
+  } else if (lead >= 0xf0 && lead <= 0xf4) {
+    count = 4;
+    low = lead == 0xf0 ? 0x90 : 0x80;
+    high = lead == 0xf4 ? 0x8f : 0xbf;
+  } else {
+    return 0;
+  }
+  if (size - i < count || data[i + 1] < low || data[i + 1] > high) {
+    return 0;
+  }
+  for (size_t k = 2; k < count; ++k) {
+    if ((data[i + k] & 0xc0) != 0x80) {
+      return 0;
+    }
+  }
+  return count;
+}
+
+inline bool ValidateUtf8Scalar(const char* text, size_t size) {
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(text);
+  size_t i = 0;
+  while (i < size) {
+    if (i + 8 <= size) {
+      uint64_t word;
+      std::memcpy(&word, data + i, 8);
+      if ((word & 0x8080808080808080ull) == 0) {
+        i += 8;
+        continue;
+      }
+    }
+    if (data[i] < 0x80) {
+      ++i;
+      continue;
+    }
+    size_t count = Utf8SequenceSize(data, size, i);
+    if (count == 0) {
+      return false;
+    }
+    i += count;
+  }
+  return true;
+}
+
+#if defined(__AVX2__)
+// The lookup validator of Keiser and Lemire, "Validating UTF-8 in less than
+// one instruction per byte". Three 16-entry tables, indexed with vpshufb by
+// the high and low nibble of the previous byte and the high nibble of the
+// current one, flag every error that shows in a pair of bytes; the bits
+// that survive the AND of the three are errors. Continuation bytes that are
+// the third or fourth of a sequence are checked separately against the
+// bytes two and three back.
+const uint8_t kUtf8TooShort = 1 << 0;
+const uint8_t kUtf8TooLong = 1 << 1;
+const uint8_t kUtf8Overlong3 = 1 << 2;
+const uint8_t kUtf8TooLarge = 1 << 3;
+const uint8_t kUtf8Surrogate = 1 << 4;
+const uint8_t kUtf8Overlong2 = 1 << 5;
+const uint8_t kUtf8TooLarge1000 = 1 << 6;
+const uint8_t kUtf8Overlong4 = 1 << 6;
+const uint8_t kUtf8TwoConts = 1 << 7;
+const uint8_t kUtf8Carry = kUtf8TooShort | kUtf8TooLong | kUtf8TwoConts;
+
+alignas(16) const uint8_t kUtf8Byte1High[16] = {
+    kUtf8TooLong, kUtf8TooLong, kUtf8TooLong, kUtf8TooLong,
+    kUtf8TooLong, kUtf8TooLong, kUtf8TooLong, kUtf8TooLong,
+    kUtf8TwoConts, kUtf8TwoConts, kUtf8TwoConts, kUtf8TwoConts,
+    kUtf8TooShort | kUtf8Overlong2,
+    kUtf8TooShort,
+    kUtf8TooShort | kUtf8Overlong3 | kUtf8Surrogate,
+    kUtf8TooShort | kUtf8TooLarge | kUtf8TooLarge1000 | kUtf8Overlong4,
+};
+
+alignas(16) const uint8_t kUtf8Byte1Low[16] = {
+    kUtf8Carry | kUtf8Overlong3 | kUtf8Overlong2 | kUtf8Overlong4,
+    kUtf8Carry | kUtf8Overlong2,
+    kUtf8Carry,
+    kUtf8Carry,
+    kUtf8Carry | kUtf8TooLarge,
+    kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000,
+    kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000,
+    kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000,
+    kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000,
+    kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000,
+    kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000,
+    kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000,
+    kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000,
+    kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000 | kUtf8Surrogate,
+    kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000,
+    kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000,
+};
+
+alignas(16) const uint8_t kUtf8Byte2High[16] = {
+    kUtf8TooShort, kUtf8TooShort, kUtf8TooShort, kUtf8TooShort,
+    kUtf8TooShort, kUtf8TooShort, kUtf8TooShort, kUtf8TooShort,
+    kUtf8TooLong | kUtf8Overlong2 | kUtf8TwoConts | kUtf8Overlong3 |
+        kUtf8TooLarge1000 | kUtf8Overlong4,
+    kUtf8TooLong | kUtf8Overlong2 | kUtf8TwoConts | kUtf8Overlong3 |
+        kUtf8TooLarge,
+    kUtf8TooLong | kUtf8Overlong2 | kUtf8TwoConts | kUtf8Surrogate |
+        kUtf8TooLarge,
+    kUtf8TooLong | kUtf8Overlong2 | kUtf8TwoConts | kUtf8Surrogate |
+        kUtf8TooLarge,
+    kUtf8TooShort, kUtf8TooShort, kUtf8TooShort, kUtf8TooShort,
+};
+
+// Bytes past which a sequence started in the last three bytes of a block
+// cannot be complete.
+alignas(32) const uint8_t kUtf8MaxTail[32] = {
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xef, 0xdf, 0xbf,
+};
+
+inline __m256i Utf8Lookup(const uint8_t* table, __m256i nibbles) {
+  __m256i lookup = _mm256_broadcastsi128_si256(
+      _mm_load_si128(reinterpret_cast<const __m128i*>(table)));
+  return _mm256_shuffle_epi8(lookup, nibbles);
+}
+
+// Block shifted right by count bytes, with the last bytes of prev in
+// front.
+template <int count>
+__m256i Utf8Previous(__m256i block, __m256i prev) {
+  return _mm256_alignr_epi8(
+      block, _mm256_permute2x128_si256(prev, block, 0x21), 16 - count);
+}
+
+inline __m256i Utf8BlockErrors(__m256i block, __m256i prev) {
+  __m256i low_nibble = _mm256_set1_epi8(0x0f);
+  __m256i prev1 = Utf8Previous<1>(block, prev);
+  __m256i special = _mm256_and_si256(
+      _mm256_and_si256(
+          Utf8Lookup(kUtf8Byte1High,
+                     _mm256_and_si256(_mm256_srli_epi16(prev1, 4),
+                                      low_nibble)),
+          Utf8Lookup(kUtf8Byte1Low, _mm256_and_si256(prev1, low_nibble))),
+      Utf8Lookup(kUtf8Byte2High,
+                 _mm256_and_si256(_mm256_srli_epi16(block, 4), low_nibble)));
+  // Only bytes two back of at least 0xe0 or three back of at least 0xf0
+  // end up with the top bit set; exactly those need a continuation here.
+  __m256i third = _mm256_subs_epu8(Utf8Previous<2>(block, prev),
+                                   _mm256_set1_epi8(0xe0 - 0x80));
+  __m256i fourth = _mm256_subs_epu8(Utf8Previous<3>(block, prev),
+                                    _mm256_set1_epi8(0xf0 - 0x80));
+  __m256i must_continue =
+      _mm256_and_si256(_mm256_or_si256(third, fourth),
+                       _mm256_set1_epi8(static_cast<char>(0x80)));
+  return _mm256_xor_si256(must_continue, special);
+}
+#endif
+
+// Whether str is well-formed UTF-8 as defined by RFC 3629.
+inline bool ValidateUtf8(StringView str) {
+#if defined(__AVX2__)
+  const char* data = str.Data();
+  size_t size = str.Size();
+  __m256i error = _mm256_setzero_si256();
+  __m256i prev = _mm256_setzero_si256();
+  // Nonzero when prev ends in the middle of a sequence.
+  __m256i incomplete = _mm256_setzero_si256();
+  __m256i max_tail =
+      _mm256_load_si256(reinterpret_cast<const __m256i*>(kUtf8MaxTail));
+  auto check = [&](__m256i block) {
+    if (_mm256_movemask_epi8(block) == 0) {
+      // All ASCII, so fine unless the previous block was cut short.
+      error = _mm256_or_si256(error, incomplete);
+      incomplete = _mm256_setzero_si256();
+    } else {
+      error = _mm256_or_si256(error, Utf8BlockErrors(block, prev));
+      incomplete = _mm256_subs_epu8(block, max_tail);
+    }
+    prev = block;
+  };
+  size_t i = 0;
+  for (; i + 32 <= size; i += 32) {
+    check(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)));
+  }
+  if (i < size) {
+    // The zero padding reads as ASCII, which cuts off an unfinished
+    // sequence as it should.
+    alignas(32) char tail[32] = {};
+    std::memcpy(tail, data + i, size - i);
+    check(_mm256_load_si256(reinterpret_cast<const __m256i*>(tail)));
+  }
+  error = _mm256_or_si256(error, incomplete);
+  return _mm256_testz_si256(error, error) != 0;
+#else
+  return ValidateUtf8Scalar(str.Data(), str.Size());
+#endif
+}
@@ -0,0 +1,235 @@
+#pragma once
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+#include "StringHash.hpp"
+#include "StringSearch.hpp"
+
+template <typename Delimiter>
+class BasicSplitView;
+// Tokens separated by a delimiter string.
+using SplitView = BasicSplitView<Searcher>;
+// Tokens separated by any byte of a set.
+using SplitAnyView = BasicSplitView<ByteSet>;
+
+// Non-owning, read-only window of size characters starting at data. The
+// characters are not copied, so a view is only valid while the string it
+// points into is alive and unmodified.
+class StringView {
+ public:
+  static const size_t kNpos = kStringNpos;
+
+  constexpr StringView() = default;
+  constexpr StringView(const char* data, size_t size)
+      : data_(data), size_(size) {}
+  StringView(const char* str) : StringView(str, strlen(str)) {}
+
+  constexpr const char* Data() const { return data_; }
+  constexpr size_t Size() const { return size_; }
+  constexpr bool Empty() const { return size_ == 0; }
+  constexpr const char& operator[](size_t index) const { return data_[index]; }
+  constexpr const char& Front() const { return data_[0]; }
+  constexpr const char& Back() const { return data_[size_ - 1]; }
+  constexpr const char* begin() const { return data_; }
+  constexpr const char* end() const { return data_ + size_; }
+
+  // View of at most count characters starting at pos.
+  StringView Substr(size_t pos, size_t count = kNpos) const;
+  void RemovePrefix(size_t count);
+  void RemoveSuffix(size_t count);
+
+  // Position of the first occurrence of needle at or after pos, or kNpos.
+  size_t Find(StringView needle, size_t pos = 0) const;
+  size_t Find(char character, size_t pos = 0) const;
+  // Starts of the non-overlapping occurrences of needle, left to right.
+  std::vector<size_t> FindAll(StringView needle) const;
+  // Position of the first byte at or after pos that is one of bytes.
+  size_t FindFirstOf(StringView bytes, size_t pos = 0) const;
+
+  // Lazily splits the view on delim, yielding one view per token, including
+  // empty ones between adjacent delimiters. An empty delim yields the whole
+  // view as a single token.
+  SplitView Split(StringView delim = " ") const;
+  // Splits on every byte that occurs in delims.
+  SplitAnyView SplitAny(StringView delims) const;
+
+ private:
+  const char* data_ = nullptr;
+  size_t size_ = 0;
+};
+
+inline bool operator==(StringView str1, StringView str2) {
+  return str1.Size() == str2.Size() &&
+         std::memcmp(str1.Data(), str2.Data(), str1.Size()) == 0;
+}
+
+// Lexicographic byte order. memcmp compares the common prefix with the
+// widest vectors the C library has, and only then do the sizes decide.
+inline std::strong_ordering operator<=>(StringView str1, StringView str2) {
+  int cmp = std::memcmp(str1.Data(), str2.Data(),
+                        std::min(str1.Size(), str2.Size()));
+  if (cmp != 0) {
+    return cmp < 0 ? std::strong_ordering::less : std::strong_ordering::greater;
+  }
+  return str1.Size() <=> str2.Size();
+}
+
+inline std::ostream& operator<<(std::ostream& ostream, StringView str) {
+  return ostream.write(str.Data(), static_cast<std::streamsize>(str.Size()));
+}
+
+template <>
+struct std::hash<StringView> {
+  size_t operator()(StringView str) const {
+    return HashBytes(str.Data(), str.Size());
+  }
+};
+
+// Forward range over the tokens of a view. Delimiter is a precompiled
+// matcher (Searcher or ByteSet); each step searches for the next match only,
+// so walking the tokens of a buffer allocates nothing. The range and its
+// iterators refer to the text and to the needle, not to the range object.
+template <typename Delimiter>
+class BasicSplitView {
+ public:
+  class Iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = StringView;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const StringView*;
+    using reference = const StringView&;
+
+    Iterator() = default;
+
+    reference operator*() const { return token_; }
+    pointer operator->() const { return &token_; }
+    Iterator& operator++();
+    Iterator operator++(int);
+
+    bool operator==(const Iterator& iter) const {
+      return done_ == iter.done_ && (done_ || next_ == iter.next_);
+    }
+    bool operator!=(const Iterator& iter) const { return !(*this == iter); }
+
+   private:
+    friend class BasicSplitView;
+
+    Iterator(StringView text, const Delimiter& delim);
+
+    StringView text_;
+    Delimiter delim_;
+    StringView token_;
+    // Start of the token after token_, or kNpos when token_ is the last one.
+    size_t next_ = 0;
+    bool done_ = true;
+  };
+
+  using iterator = Iterator;
+
+  BasicSplitView(StringView text, const Delimiter& delim)
+      : text_(text), delim_(delim) {}
+
+  Iterator begin() const { return Iterator(text_, delim_); }
+  Iterator end() const { return Iterator(); }
+
+ private:
+  StringView text_;
+  Delimiter delim_;
+};
+
+inline StringView StringView::Substr(size_t pos, size_t count) const {
+  if (pos > size_) {
+    throw std::out_of_range("Out of range");
+  }
+  return StringView(data_ + pos, std::min(count, size_ - pos));
+}
+
+inline void StringView::RemovePrefix(size_t count) {
+  data_ += count;
+  size_ -= count;
+}
+
+inline void StringView::RemoveSuffix(size_t count) { size_ -= count; }
+
+inline size_t StringView::Find(char character, size_t pos) const {
+  if (pos >= size_) {
+    return kNpos;
+  }
+  const void* found = std::memchr(data_ + pos, character, size_ - pos);
+  return found == nullptr ? kNpos : static_cast<const char*>(found) - data_;
+}
+
+inline size_t StringView::Find(StringView needle, size_t pos) const {
+  return Searcher(needle.Data(), needle.Size()).Find(data_, size_, pos);
+}
+
+inline std::vector<size_t> StringView::FindAll(StringView needle) const {
+  std::vector<size_t> res;
+  if (needle.Empty()) {
+    return res;
+  }
+  Searcher searcher(needle.Data(), needle.Size());
+  for (size_t pos = searcher.Find(data_, size_); pos != kNpos;
+       pos = searcher.Find(data_, size_, pos + needle.Size())) {
+    res.push_back(pos);
+  }
+  return res;
+}
+
+inline size_t StringView::FindFirstOf(StringView bytes, size_t pos) const {
+  if (pos >= size_) {
+    return kNpos;
+  }
+  return ByteSet(bytes.Data(), bytes.Size()).Find(data_, size_, pos);
+}
+
+inline SplitView StringView::Split(StringView delim) const {
+  return SplitView(*this, Searcher(delim.Data(), delim.Size()));
+}
+
+inline SplitAnyView StringView::SplitAny(StringView delims) const {
+  return SplitAnyView(*this, ByteSet(delims.Data(), delims.Size()));
+}
+
+template <typename Delimiter>
+BasicSplitView<Delimiter>::Iterator::Iterator(StringView text,
+                                              const Delimiter& delim)
+    : text_(text), delim_(delim), done_(false) {
+  ++*this;
+}
+
+template <typename Delimiter>
+typename BasicSplitView<Delimiter>::Iterator&
+BasicSplitView<Delimiter>::Iterator::operator++() {
+  if (next_ == StringView::kNpos) {
+    done_ = true;
+    return *this;
+  }
+  size_t end = delim_.MatchSize() == 0
+                   ? StringView::kNpos
+                   : delim_.Find(text_.Data(), text_.Size(), next_);
+  if (end == StringView::kNpos) {
+    token_ = text_.Substr(next_);
+    next_ = StringView::kNpos;
+  } else {
+    token_ = text_.Substr(next_, end - next_);
+    next_ = end + delim_.MatchSize();
+  }
+  return *this;
+}
+
+template <typename Delimiter>
+typename BasicSplitView<Delimiter>::Iterator
+BasicSplitView<Delimiter>::Iterator::operator++(int) {
+  Iterator iter(*this);
+  ++*this;
+  return iter;
+}